@@ -43,6 +43,48 @@ extern "C" {
 
 #define MAX_PRINTF_LEN 64
 
+// FIN/opcode, length, extended 16 bits length, masking key
+#define WS_MAX_HEADER_LEN 8
+
+// XOR data with the 4 bytes masking key, data[0] being at offset in the masked payload.
+// Byte by byte only until data is aligned, then a word at a time
+static void webSocketMask(uint8_t *data, size_t len, const uint8_t *key, size_t offset)
+{
+  size_t i = 0;
+
+  while ((i < len) && ((uintptr_t)(data + i) & 3))
+  {
+    data[i] ^= key[(offset + i) & 3];
+    i++;
+  }
+
+  if (len - i >= 4)
+  {
+    // Key rotated to start at data + i, in memory order so it doesn't depend on endianness
+    uint8_t rotated[4];
+
+    for (size_t k = 0; k < 4; k++)
+      rotated[k] = key[(offset + i + k) & 3];
+
+    uint32_t word;
+    memcpy(&word, rotated, 4);
+
+    uint32_t *words = (uint32_t *)(data + i);
+    size_t count = (len - i) / 4;
+
+    for (size_t w = 0; w < count; w++)
+      words[w] ^= word;
+
+    i += count * 4;
+  }
+
+  while (i < len)
+  {
+    data[i] ^= key[(offset + i) & 3];
+    i++;
+  }
+}
+
 size_t webSocketSendFrameWindow(AsyncClient *client)
 {
   if (!client->canSend())
@@ -72,10 +114,14 @@ size_t webSocketSendFrame(AsyncClient *client, bool final, uint8_t opcode, bool
   if (len && mask)
   {
     headLen += 4;
-    mbuf[0] = rand() % 0xFF;
-    mbuf[1] = rand() % 0xFF;
-    mbuf[2] = rand() % 0xFF;
-    mbuf[3] = rand() % 0xFF;
+
+#ifdef ESP8266
+    uint32_t key = RANDOM_REG32;
+#else
+    uint32_t key = esp_random();
+#endif
+
+    memcpy(mbuf, &key, 4);
   }
 
   if (len > 125)
@@ -89,13 +135,8 @@ size_t webSocketSendFrame(AsyncClient *client, bool final, uint8_t opcode, bool
   if (len > space)
     len = space;
 
-  uint8_t *buf = (uint8_t*)malloc(headLen);
-
-  if (buf == NULL)
-  {
-    //os_printf("could not malloc %u bytes for frame header\n", headLen);
-    return 0;
-  }
+  // Copied by client->add(), so it can live on the stack
+  uint8_t buf[WS_MAX_HEADER_LEN];
 
   buf[0] = opcode & 0x0F;
 
@@ -120,21 +161,13 @@ size_t webSocketSendFrame(AsyncClient *client, bool final, uint8_t opcode, bool
   if (client->add((const char *)buf, headLen) != headLen)
   {
     //os_printf("error adding %lu header bytes\n", headLen);
-    free(buf);
     return 0;
   }
 
-  free(buf);
-
   if (len)
   {
     if (len && mask)
-    {
-      size_t i;
-
-      for (i = 0; i < len; i++)
-        data[i] = data[i] ^ mbuf[i % 4];
-    }
+      webSocketMask(data, len, mbuf, 0);
 
     if (client->add((const char *)data, len) != len)
     {
@@ -850,10 +883,7 @@ void AsyncWebSocketClient::_onData(void *pbuf, size_t plen)
     const auto datalast = data[datalen];
 
     if (_pinfo.masked)
-    {
-      for (size_t i = 0; i < datalen; i++)
-        data[i] ^= _pinfo.mask[(_pinfo.index + i) % 4];
-    }
+      webSocketMask(data, datalen, _pinfo.mask, _pinfo.index);
 
     if ((datalen + _pinfo.index) < _pinfo.len)
     {
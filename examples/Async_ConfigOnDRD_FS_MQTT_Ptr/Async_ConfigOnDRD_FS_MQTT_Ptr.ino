@@ -862,6 +862,11 @@ void wifi_manager()
   // Use this to personalize DHCP hostname (RFC952 conformed)
   AsyncWebServer webServer(HTTP_PORT);
 
+  // One heap block for the parameter table and the 4 parameter values, freed at once when leaving.
+  // Each value takes its parameter's length + 1
+  ESPAsync_WMParamArena paramArena(4, (custom_AIO_SERVER_LEN + 2) + (custom_AIO_PORT_LEN + 2) +
+                                   (custom_AIO_USERNAME_LEN + 2) + (custom_AIO_KEY_LEN + 2));
+
 #if ( USING_ESP32_S2 || USING_ESP32_C3 )
   ESPAsync_WiFiManager ESPAsync_wifiManager(&webServer, NULL, "ConfigOnDRD-FS-MQTT");
 #else
@@ -906,18 +911,22 @@ void wifi_manager()
   // (*** we are not using <custom HTML> and <label placement> ***)
 
   // AIO_SERVER
-  ESPAsync_WMParameter AIO_SERVER_FIELD(AIO_SERVER_Label, "AIO SERVER", custom_AIO_SERVER, custom_AIO_SERVER_LEN + 1);
+  ESPAsync_WMParameter AIO_SERVER_FIELD(paramArena, AIO_SERVER_Label, "AIO SERVER", custom_AIO_SERVER,
+                                        custom_AIO_SERVER_LEN + 1);
 
   // AIO_SERVERPORT
-  ESPAsync_WMParameter AIO_SERVERPORT_FIELD(AIO_SERVERPORT_Label, "AIO SERVER PORT", custom_AIO_SERVERPORT,
+  ESPAsync_WMParameter AIO_SERVERPORT_FIELD(paramArena, AIO_SERVERPORT_Label, "AIO SERVER PORT", custom_AIO_SERVERPORT,
                                             custom_AIO_PORT_LEN + 1);
 
   // AIO_USERNAME
-  ESPAsync_WMParameter AIO_USERNAME_FIELD(AIO_USERNAME_Label, "AIO USERNAME", custom_AIO_USERNAME,
+  ESPAsync_WMParameter AIO_USERNAME_FIELD(paramArena, AIO_USERNAME_Label, "AIO USERNAME", custom_AIO_USERNAME,
                                           custom_AIO_USERNAME_LEN + 1);
 
   // AIO_KEY
-  ESPAsync_WMParameter AIO_KEY_FIELD(AIO_KEY_Label, "AIO KEY", custom_AIO_KEY, custom_AIO_KEY_LEN + 1);
+  ESPAsync_WMParameter AIO_KEY_FIELD(paramArena, AIO_KEY_Label, "AIO KEY", custom_AIO_KEY, custom_AIO_KEY_LEN + 1);
+
+  // Parameter table in the arena too, no realloc()
+  ESPAsync_wifiManager.setParamArena(&paramArena);
 
   // add all parameters here
   // order of adding is not important
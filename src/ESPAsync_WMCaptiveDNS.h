@@ -0,0 +1,250 @@
+/****************************************************************************************************************************
+  ESPAsync_WMCaptiveDNS.h
+  For ESP8266 / ESP32 boards
+
+  ESPAsync_WiFiManager is a library for the ESP8266/Arduino platform, using (ESP)AsyncWebServer to enable easy
+  configuration and reconfiguration of WiFi credentials using a Captive Portal.
+
+  Built by Khoi Hoang https://github.com/khoih-prog/ESPAsync_WiFiManager
+  Licensed under MIT license
+
+  Captive portal DNS responder on AsyncUDP, used with USE_WM_CAPTIVE_DNS instead of AsyncDNSServer.
+
+  Every name resolves to the portal IP. The answer record is built once by start(). A query is answered by
+  copying its header and question into a preallocated buffer, patching the header and appending that
+  record, so nothing is allocated nor parsed beyond the question.
+  Only A (and ANY) queries get an answer. AAAA, HTTPS, SVCB and all the other types get an empty NOERROR
+  reply right away, so that clients don't wait for an IPv6 address or a service binding before falling
+  back to IPv4 and showing the captive portal popup.
+ *****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef ESPAsync_WMCaptiveDNS_h
+#define ESPAsync_WMCaptiveDNS_h
+
+#include <Arduino.h>
+
+#ifdef ESP8266
+  #include <ESPAsyncUDP.h>
+#else
+  #include <AsyncUDP.h>
+#endif
+
+////////////////////////////////////////////////////
+
+// Short, the real DNS must take over as soon as the device is configured
+#ifndef WM_CAPTIVE_DNS_TTL
+  #define WM_CAPTIVE_DNS_TTL        60
+#endif
+
+#define WM_DNS_HEADER_SIZE          12
+#define WM_DNS_MAX_NAME             255
+
+// Compressed name pointing to the question, type, class, TTL, length, IPv4 address
+#define WM_DNS_ANSWER_SIZE          16
+
+// Header, question and one answer
+#define WM_DNS_MAX_RESPONSE         ( WM_DNS_HEADER_SIZE + WM_DNS_MAX_NAME + 1 + 4 + WM_DNS_ANSWER_SIZE )
+
+#define WM_DNS_TYPE_A               1
+#define WM_DNS_TYPE_ANY             255
+#define WM_DNS_CLASS_IN             1
+#define WM_DNS_CLASS_ANY            255
+
+#define WM_DNS_RCODE_NOERROR        0
+#define WM_DNS_RCODE_FORMERR        1
+#define WM_DNS_RCODE_NOTIMP         4
+
+////////////////////////////////////////////////////
+
+class ESPAsync_WMCaptiveDNS
+{
+  public:
+
+    ESPAsync_WMCaptiveDNS()
+    {
+    }
+
+    ~ESPAsync_WMCaptiveDNS()
+    {
+      stop();
+    }
+
+    ////////////////////////////////////////////////////
+
+    bool start(const IPAddress& ip, const uint16_t& port = 53, const uint32_t& ttl = WM_CAPTIVE_DNS_TTL)
+    {
+      stop();
+
+      uint8_t *answer = _answer;
+
+      // Pointer to the name of the question, always at offset 12
+      *answer++ = 0xC0;
+      *answer++ = WM_DNS_HEADER_SIZE;
+
+      answer = put16(answer, WM_DNS_TYPE_A);
+      answer = put16(answer, WM_DNS_CLASS_IN);
+      answer = put16(answer, ttl >> 16);
+      answer = put16(answer, ttl & 0xFFFF);
+      answer = put16(answer, 4);
+
+      for (int i = 0; i < 4; i++)
+        *answer++ = ip[i];
+
+      if (!_udp.listen(port))
+        return false;
+
+      // Replies are built in _response, the packets are handled one at a time
+      _udp.onPacket([this](AsyncUDPPacket & packet)
+      {
+        size_t length = reply(packet.data(), packet.length());
+
+        if (length > 0)
+          packet.write(_response, length);
+      });
+
+      _started = true;
+
+      return true;
+    }
+
+    ////////////////////////////////////////////////////
+
+    void stop()
+    {
+      if (_started)
+      {
+        _udp.close();
+        _started = false;
+      }
+    }
+
+    ////////////////////////////////////////////////////
+
+    // Build the reply to query in response(). Returns its length, 0 to ignore the packet
+    size_t reply(const uint8_t* query, const size_t& length)
+    {
+      _queries++;
+
+      // Only answer standard queries
+      if ( (length < WM_DNS_HEADER_SIZE) || (query[2] & 0x80) )
+        return 0;
+
+      uint8_t opcode = (query[2] >> 3) & 0x0F;
+
+      if (opcode != 0)
+        return error(query, WM_DNS_RCODE_NOTIMP);
+
+      if (get16(query + 4) != 1)
+        return error(query, WM_DNS_RCODE_FORMERR);
+
+      // Walk the labels of the question's name. No compression in a question
+      size_t end = WM_DNS_HEADER_SIZE;
+
+      while ( (end < length) && (query[end] != 0) )
+      {
+        if ( (query[end] > 63) || (end + query[end] + 1 - WM_DNS_HEADER_SIZE > WM_DNS_MAX_NAME) )
+          return error(query, WM_DNS_RCODE_FORMERR);
+
+        end += query[end] + 1;
+      }
+
+      // Root label, type and class
+      end += 1 + 4;
+
+      if (end > length)
+        return error(query, WM_DNS_RCODE_FORMERR);
+
+      uint16_t type   = get16(query + end - 4);
+      uint16_t qclass = get16(query + end - 2);
+
+      bool answered = ( (type == WM_DNS_TYPE_A) || (type == WM_DNS_TYPE_ANY) ) &&
+                      ( (qclass == WM_DNS_CLASS_IN) || (qclass == WM_DNS_CLASS_ANY) );
+
+      // Anything after the question, an EDNS record for instance, is dropped
+      memcpy(_response, query, end);
+      header(WM_DNS_RCODE_NOERROR, answered ? 1 : 0);
+
+      if (!answered)
+        return end;
+
+      memcpy(_response + end, _answer, WM_DNS_ANSWER_SIZE);
+      _answers++;
+
+      return end + WM_DNS_ANSWER_SIZE;
+    }
+
+    ////////////////////////////////////////////////////
+
+    inline const uint8_t* response()
+    {
+      return _response;
+    }
+
+    inline uint32_t queries()
+    {
+      return _queries;
+    }
+
+    inline uint32_t answers()
+    {
+      return _answers;
+    }
+
+    ////////////////////////////////////////////////////
+
+  private:
+
+    AsyncUDP      _udp;
+    bool          _started      = false;
+
+    uint8_t       _answer[WM_DNS_ANSWER_SIZE];
+    uint8_t       _response[WM_DNS_MAX_RESPONSE];
+
+    uint32_t      _queries      = 0;
+    uint32_t      _answers      = 0;
+
+    ////////////////////////////////////////////////////
+
+    static inline uint16_t get16(const uint8_t* data)
+    {
+      return (data[0] << 8) | data[1];
+    }
+
+    static inline uint8_t* put16(uint8_t* data, const uint16_t& value)
+    {
+      data[0] = value >> 8;
+      data[1] = value & 0xFF;
+
+      return data + 2;
+    }
+
+    ////////////////////////////////////////////////////
+
+    // Turn the query header copied in _response into the reply header
+    void header(const uint8_t& rcode, const uint16_t& answers)
+    {
+      // QR, same opcode, AA, same RD. RA
+      _response[2] = 0x80 | (_response[2] & 0x79) | 0x04;
+      _response[3] = 0x80 | rcode;
+
+      put16(_response + 6,  answers);
+      put16(_response + 8,  0);
+      put16(_response + 10, 0);
+    }
+
+    ////////////////////////////////////////////////////
+
+    // Header only reply
+    size_t error(const uint8_t* query, const uint8_t& rcode)
+    {
+      memcpy(_response, query, WM_DNS_HEADER_SIZE);
+      header(rcode, 0);
+      put16(_response + 4, 0);
+
+      return WM_DNS_HEADER_SIZE;
+    }
+};
+
+#endif    // ESPAsync_WMCaptiveDNS_h
@@ -0,0 +1,293 @@
+/****************************************************************************************************************************
+  ESPAsync_WMConfigStore.h
+  For ESP8266 / ESP32 boards
+
+  ESPAsync_WiFiManager is a library for the ESP8266/Arduino platform, using (ESP)AsyncWebServer to enable easy
+  configuration and reconfiguration of WiFi credentials using a Captive Portal.
+
+  Built by Khoi Hoang https://github.com/khoih-prog/ESPAsync_WiFiManager
+  Licensed under MIT license
+
+  Crash-safe store for a small config record, such as the sketch's WM_Config.
+
+  The file holds two fixed size slots, written alternately. Each slot is a header
+  (magic, schema version, length, sequence number, CRC32) followed by the record.
+  A save only rewrites the slot holding the older record, so a power cut at any byte
+  leaves the newer one intact. Boot reads both slots at once and keeps the valid one
+  with the highest sequence number.
+ *****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef ESPAsync_WMConfigStore_h
+#define ESPAsync_WMConfigStore_h
+
+#include <FS.h>
+
+#include "ESPAsync_WiFiManager_Debug.h"
+
+////////////////////////////////////////////////////
+
+#define WM_CONFIG_STORE_MAGIC       0x53434D57UL    // "WMCS"
+#define WM_CONFIG_STORE_SLOTS       2
+
+class ESPAsync_WMConfigStore
+{
+  public:
+
+    // maxLength : largest record that will ever be saved. Changing it changes the file layout
+    ESPAsync_WMConfigStore(fs::FS& fileSystem, const char* path, const uint16_t& maxLength)
+      : _fs(fileSystem), _path(path), _maxLength(maxLength)
+    {
+    }
+
+    ////////////////////////////////////////////////////
+
+    // Copies the newest valid record into data. Returns its length, 0 if there is none.
+    // version is the schema version it was saved with, so that the caller can migrate it
+    size_t load(void* data, const size_t& maxLength, uint16_t& version)
+    {
+      uint8_t *image = readImage();
+
+      if (!image)
+        return 0;
+
+      int slot = newestSlot(image);
+
+      size_t length = 0;
+
+      if (slot >= 0)
+      {
+        const Header *header = (const Header *) (image + slot * slotSize());
+
+        length  = std::min((size_t) header->length, maxLength);
+        version = header->version;
+
+        memcpy(data, (const uint8_t *) header + sizeof(Header), length);
+
+        LOGINFO3(F("ConfigStore: loaded slot"), slot, F(", seq ="), header->sequence);
+      }
+      else
+      {
+        LOGWARN(F("ConfigStore: no valid record"));
+      }
+
+      free(image);
+
+      return length;
+    }
+
+    ////////////////////////////////////////////////////
+
+    bool save(const void* data, const size_t& length, const uint16_t& version)
+    {
+      if (length > _maxLength)
+      {
+        LOGERROR1(F("ConfigStore: record too long ="), length);
+        return false;
+      }
+
+      if (!_scanned)
+      {
+        // Find out which slot holds the newest record
+        uint8_t *image = readImage();
+
+        if (image)
+          free(image);
+      }
+
+      // Overwrite the older slot, never the newest valid record
+      int slot = (_newestSlot < 0) ? 0 : (1 - _newestSlot);
+
+      uint8_t *buffer = (uint8_t *) calloc(1, slotSize());
+
+      if (!buffer)
+        return false;
+
+      Header *header = (Header *) buffer;
+
+      header->magic     = WM_CONFIG_STORE_MAGIC;
+      header->version   = version;
+      header->length    = length;
+      header->sequence  = _sequence + 1;
+
+      memcpy(buffer + sizeof(Header), data, length);
+
+      header->crc       = recordCRC(header);
+
+      uint32_t sequence = header->sequence;
+
+      slot = writeSlot(slot, buffer);
+
+      free(buffer);
+
+      bool ok = (slot >= 0);
+
+      if (ok)
+      {
+        _newestSlot = slot;
+        _sequence   = sequence;
+
+        LOGINFO3(F("ConfigStore: saved slot"), slot, F(", seq ="), _sequence);
+      }
+      else
+      {
+        LOGERROR(F("ConfigStore: write failed"));
+      }
+
+      return ok;
+    }
+
+    ////////////////////////////////////////////////////
+
+    inline uint32_t sequence()
+    {
+      return _sequence;
+    }
+
+    ////////////////////////////////////////////////////
+
+    // CRC-32 (IEEE 802.3), 4 bits at a time with a 16 entry table
+    static uint32_t crc32(const void* data, const size_t& length, uint32_t crc = 0)
+    {
+      static const uint32_t table[16] =
+      {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+      };
+
+      const uint8_t *p = (const uint8_t *) data;
+
+      crc = ~crc;
+
+      for (size_t i = 0; i < length; i++)
+      {
+        crc = table[(crc ^ p[i]) & 0x0F] ^ (crc >> 4);
+        crc = table[(crc ^ (p[i] >> 4)) & 0x0F] ^ (crc >> 4);
+      }
+
+      return ~crc;
+    }
+
+  ////////////////////////////////////////////////////
+
+  private:
+
+    typedef struct
+    {
+      uint32_t  magic;
+      uint16_t  version;      // Schema version of the record, up to the caller
+      uint16_t  length;       // Record length
+      uint32_t  sequence;     // Incremented on every save
+      uint32_t  crc;          // Over the header fields above and the record
+    } Header;
+
+    fs::FS&     _fs;
+    const char* _path;
+    uint16_t    _maxLength;
+
+    bool        _scanned      = false;
+    int         _newestSlot   = -1;
+    uint32_t    _sequence     = 0;
+
+    ////////////////////////////////////////////////////
+
+    inline size_t slotSize()
+    {
+      // Keep the slots 4 bytes aligned
+      return (sizeof(Header) + _maxLength + 3) & ~3;
+    }
+
+    ////////////////////////////////////////////////////
+
+    uint32_t recordCRC(const Header* header)
+    {
+      uint32_t crc = crc32(header, offsetof(Header, crc));
+
+      return crc32((const uint8_t *) header + sizeof(Header), header->length, crc);
+    }
+
+    ////////////////////////////////////////////////////
+
+    bool isValid(const Header* header)
+    {
+      return ( (header->magic == WM_CONFIG_STORE_MAGIC) && (header->length <= _maxLength) &&
+               (header->crc == recordCRC(header)) );
+    }
+
+    ////////////////////////////////////////////////////
+
+    // Also remembers it, and its sequence number, for the next save()
+    int newestSlot(const uint8_t* image)
+    {
+      _newestSlot = -1;
+      _sequence   = 0;
+
+      for (int slot = 0; slot < WM_CONFIG_STORE_SLOTS; slot++)
+      {
+        const Header *header = (const Header *) (image + slot * slotSize());
+
+        // Sequence numbers compared with wrap around
+        if ( isValid(header) && ( (_newestSlot < 0) || ((int32_t) (header->sequence - _sequence) > 0) ) )
+        {
+          _newestSlot = slot;
+          _sequence   = header->sequence;
+        }
+      }
+
+      _scanned = true;
+
+      return _newestSlot;
+    }
+
+    ////////////////////////////////////////////////////
+
+    // Both slots in one read. Missing slots read as zeros, i.e. invalid. Caller frees
+    uint8_t* readImage()
+    {
+      size_t imageSize = WM_CONFIG_STORE_SLOTS * slotSize();
+
+      uint8_t *image = (uint8_t *) calloc(1, imageSize);
+
+      if (!image)
+        return NULL;
+
+      File file = _fs.open(_path, "r");
+
+      if (file)
+      {
+        file.read(image, imageSize);
+        file.close();
+      }
+
+      newestSlot(image);
+
+      return image;
+    }
+
+    ////////////////////////////////////////////////////
+
+    // Returns the slot actually written, -1 on failure
+    int writeSlot(int slot, const uint8_t* buffer)
+    {
+      // "r+" so that the other slot is never truncated. Writing at the end extends the file
+      File file = _fs.exists(_path) ? _fs.open(_path, "r+") : _fs.open(_path, "w");
+
+      if (!file)
+        return -1;
+
+      // Shorter than the slot offset : the previous slot is incomplete, hence invalid, use it
+      if (file.size() < slot * slotSize())
+        slot = 0;
+
+      bool ok = file.seek(slot * slotSize()) && (file.write(buffer, slotSize()) == slotSize());
+
+      file.close();
+
+      return ok ? slot : -1;
+    }
+};
+
+////////////////////////////////////////////////////
+
+#endif    // ESPAsync_WMConfigStore_h
@@ -0,0 +1,573 @@
+/****************************************************************************************************************************
+  ESPAsync_WMLog.h
+  For ESP8266 / ESP32 boards
+
+  ESPAsync_WiFiManager is a library for the ESP8266/Arduino platform, using (ESP)AsyncWebServer to enable easy
+  configuration and reconfiguration of WiFi credentials using a Captive Portal.
+
+  Built by Khoi Hoang https://github.com/khoih-prog/ESPAsync_WiFiManager
+  Licensed under MIT license
+
+  Deferred log backend of the LOG* macros, used with USE_WM_DEFERRED_LOG.
+
+  A LOG* call only appends a compact binary record to a preallocated RAM ring : level, millis(), and the
+  arguments as tagged values. Flash strings are kept as pointers, RAM strings are copied (truncated to
+  WM_LOG_MAX_STRING). Nothing is formatted nor printed then.
+  drain(), called from loop(), formats the records later and writes no more than the debug port accepts
+  without blocking. write() formats all the records still in the ring, for the /log portal route (USE_WM_LOG_ROUTE).
+  When the ring is full, the oldest records are dropped.
+ *****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef ESPAsync_WMLog_h
+#define ESPAsync_WMLog_h
+
+#include <Arduino.h>
+
+#include <algorithm>
+#include <type_traits>
+
+////////////////////////////////////////////////////
+
+#ifndef WM_LOG_BUFFER_SIZE
+  #define WM_LOG_BUFFER_SIZE        2048
+#endif
+
+// Longest RAM string argument kept in a record
+#ifndef WM_LOG_MAX_STRING
+  #define WM_LOG_MAX_STRING         48
+#endif
+
+// Longest formatted line, longer ones are truncated
+#define WM_LOG_MAX_LINE             160
+
+// Longest record, header included. Up to 4 arguments of WM_LOG_MAX_STRING
+#define WM_LOG_MAX_RECORD           ( 7 + 4 * (2 + WM_LOG_MAX_STRING) )
+
+#define WM_LOG_MARKED               0x80
+#define WM_LOG_LEVEL_MASK           0x07
+
+// Argument tags
+#define WM_LOG_FLASH                1
+#define WM_LOG_STRING               2
+#define WM_LOG_INT                  3
+#define WM_LOG_UINT                 4
+#define WM_LOG_FLOAT                5
+#define WM_LOG_IP                   6
+#define WM_LOG_CHAR                 7
+
+////////////////////////////////////////////////////
+
+class ESPAsync_WMLog
+{
+  public:
+
+    ESPAsync_WMLog()
+    {
+#ifdef ESP32
+      _lock = portMUX_INITIALIZER_UNLOCKED;
+#endif
+    }
+
+    ////////////////////////////////////////////////////
+
+    // level : 1 = ERROR to 4 = DEBUG. marked : "[WM] " prefix, timestamp and end of line, false for the LOG*0 macros
+    template<typename... Args>
+    void log(const uint8_t& level, const bool& marked, const Args&... args)
+    {
+      size_t size = sizeof(Header);
+
+      int sizes[] = { 0, ((size += argSize(args)), 0)... };
+      (void) sizes;
+
+      lock();
+
+      if (reserve(size))
+      {
+        Header header;
+
+        header.size   = size;
+        header.flags  = level | (marked ? WM_LOG_MARKED : 0);
+        header.ms     = millis();
+
+        put(&header, sizeof(header));
+
+        int puts[] = { 0, (putArg(args), 0)... };
+        (void) puts;
+
+        _used       += size;
+        _undrained  += size;
+      }
+
+      unlock();
+    }
+
+    ////////////////////////////////////////////////////
+
+    // Non-blocking, writes what fits in the port's TX buffer. Returns true when everything was drained
+    template<typename Port>
+    bool drain(Port& out)
+    {
+      while (true)
+      {
+        if (_lineSent == _lineLength)
+        {
+          uint8_t record[WM_LOG_MAX_RECORD];
+
+          lock();
+
+          bool pending = (_undrained > 0);
+
+          if (pending)
+          {
+            uint16_t size = recordSize(_drainPos);
+
+            read(_drainPos, record, size);
+
+            _drainPos   = (_drainPos + size) % WM_LOG_BUFFER_SIZE;
+            _undrained -= size;
+          }
+
+          unlock();
+
+          if (!pending)
+            return true;
+
+          _lineLength = format(record, _line, sizeof(_line));
+          _lineSent   = 0;
+        }
+
+        int room = out.availableForWrite();
+
+        if (room <= 0)
+          return false;
+
+        size_t length = std::min((size_t) room, (size_t) (_lineLength - _lineSent));
+
+        out.write((const uint8_t *) _line + _lineSent, length);
+
+        _lineSent += length;
+      }
+    }
+
+    ////////////////////////////////////////////////////
+
+    // All the records still in the ring, oldest first, up to maxLevel. Returns the bytes written
+    size_t write(Print& out, const uint8_t& maxLevel = 4)
+    {
+      uint8_t   record[WM_LOG_MAX_RECORD];
+      char      line[WM_LOG_MAX_LINE];
+      size_t    written = 0;
+
+      lock();
+
+      size_t    pos     = _tail;
+      size_t    used    = _used;
+      uint32_t  dropped = _dropped;
+
+      unlock();
+
+      // Copied out under the lock one at a time, the async handlers may log meanwhile
+      while (used > 0)
+      {
+        lock();
+
+        // Records dropped meanwhile, go on from the oldest one left
+        if (_dropped != dropped)
+        {
+          pos     = _tail;
+          used    = _used;
+          dropped = _dropped;
+
+          if (used == 0)
+          {
+            unlock();
+            break;
+          }
+        }
+
+        uint16_t size = recordSize(pos);
+
+        read(pos, record, size);
+
+        unlock();
+
+        if ( (record[offsetof(Header, flags)] & WM_LOG_LEVEL_MASK) <= maxLevel )
+          written += out.write((const uint8_t *) line, format(record, line, sizeof(line)));
+
+        pos   = (pos + size) % WM_LOG_BUFFER_SIZE;
+        used -= size;
+      }
+
+      if (_lost)
+      {
+        written += out.print(F("[WM] Dropped records = "));
+        written += out.println(_lost);
+      }
+
+      return written;
+    }
+
+    ////////////////////////////////////////////////////
+
+    // Records dropped before being drained
+    inline uint32_t lost()
+    {
+      return _lost;
+    }
+
+    ////////////////////////////////////////////////////
+
+  private:
+
+    typedef struct __attribute__((packed))
+    {
+      uint16_t  size;       // Whole record, arguments included
+      uint8_t   flags;      // Level | WM_LOG_MARKED
+      uint32_t  ms;
+    } Header;
+
+    uint8_t     _ring[WM_LOG_BUFFER_SIZE];
+    size_t      _head       = 0;      // Next record written here
+    size_t      _tail       = 0;      // Oldest record
+    size_t      _used       = 0;
+    size_t      _drainPos   = 0;      // Next record to drain, the undrained ones are the newest
+    size_t      _undrained  = 0;
+    uint32_t    _lost       = 0;
+    uint32_t    _dropped    = 0;      // Records dropped, drained or not
+
+    // Line being drained
+    char        _line[WM_LOG_MAX_LINE];
+    uint16_t    _lineLength = 0;
+    uint16_t    _lineSent   = 0;
+
+#ifdef ESP32
+    // Logged from the AsyncTCP task as well as from loop()
+    portMUX_TYPE  _lock;
+
+    inline void lock()
+    {
+      portENTER_CRITICAL(&_lock);
+    }
+
+    inline void unlock()
+    {
+      portEXIT_CRITICAL(&_lock);
+    }
+#else
+    // Single core, the async callbacks never preempt loop()
+    inline void lock()
+    {
+    }
+
+    inline void unlock()
+    {
+    }
+#endif
+
+    ////////////////////////////////////////////////////
+
+    inline uint8_t readByte(const size_t& pos)
+    {
+      return _ring[pos % WM_LOG_BUFFER_SIZE];
+    }
+
+    void read(size_t pos, void* data, const size_t& length)
+    {
+      for (size_t i = 0; i < length; i++)
+        ((uint8_t *) data)[i] = readByte(pos + i);
+    }
+
+    void put(const void* data, const size_t& length)
+    {
+      for (size_t i = 0; i < length; i++)
+      {
+        _ring[_head] = ((const uint8_t *) data)[i];
+        _head = (_head + 1) % WM_LOG_BUFFER_SIZE;
+      }
+    }
+
+    inline uint16_t recordSize(const size_t& pos)
+    {
+      return readByte(pos) | (readByte(pos + 1) << 8);
+    }
+
+    ////////////////////////////////////////////////////
+
+    // Drops the oldest records until size bytes are free
+    bool reserve(const size_t& size)
+    {
+      if (size > WM_LOG_MAX_RECORD)
+        return false;
+
+      while (_used + size > WM_LOG_BUFFER_SIZE)
+      {
+        uint16_t oldest = recordSize(_tail);
+
+        // All records undrained : the oldest one is lost
+        if (_undrained == _used)
+        {
+          _drainPos   = (_drainPos + oldest) % WM_LOG_BUFFER_SIZE;
+          _undrained -= oldest;
+          _lost++;
+        }
+
+        _tail   = (_tail + oldest) % WM_LOG_BUFFER_SIZE;
+        _used  -= oldest;
+        _dropped++;
+      }
+
+      return true;
+    }
+
+    ////////////////////////////////////////////////////
+
+    static inline size_t stringSize(const size_t& length)
+    {
+      return 2 + std::min(length, (size_t) WM_LOG_MAX_STRING);
+    }
+
+    size_t argSize(const __FlashStringHelper*)
+    {
+      return 1 + sizeof(void *);
+    }
+
+    size_t argSize(const char* s)
+    {
+      return stringSize(s ? strlen(s) : 0);
+    }
+
+    size_t argSize(const String& s)
+    {
+      return stringSize(s.length());
+    }
+
+    size_t argSize(const IPAddress&)
+    {
+      return 1 + sizeof(uint32_t);
+    }
+
+    size_t argSize(const char&)
+    {
+      return 2;
+    }
+
+    size_t argSize(const float&)
+    {
+      return 1 + sizeof(float);
+    }
+
+    size_t argSize(const double&)
+    {
+      return 1 + sizeof(float);
+    }
+
+    // Integers, bools and enums
+    template<typename T, typename std::enable_if<std::is_arithmetic<T>::value || std::is_enum<T>::value, int>::type = 0>
+    size_t argSize(const T&)
+    {
+      return 1 + sizeof(uint32_t);
+    }
+
+    ////////////////////////////////////////////////////
+
+    void putTag(const uint8_t& tag, const void* data, const size_t& length)
+    {
+      put(&tag, 1);
+      put(data, length);
+    }
+
+    void putString(const char* s, const size_t& length)
+    {
+      uint8_t tag = WM_LOG_STRING;
+      uint8_t len = std::min(length, (size_t) WM_LOG_MAX_STRING);
+
+      put(&tag, 1);
+      put(&len, 1);
+      put(s, len);
+    }
+
+    void putArg(const __FlashStringHelper* s)
+    {
+      putTag(WM_LOG_FLASH, &s, sizeof(s));
+    }
+
+    void putArg(const char* s)
+    {
+      putString(s ? s : "", s ? strlen(s) : 0);
+    }
+
+    void putArg(const String& s)
+    {
+      putString(s.c_str(), s.length());
+    }
+
+    void putArg(const IPAddress& ip)
+    {
+      uint32_t value = (uint32_t) ip;
+
+      putTag(WM_LOG_IP, &value, sizeof(value));
+    }
+
+    void putArg(const char& c)
+    {
+      putTag(WM_LOG_CHAR, &c, 1);
+    }
+
+    void putArg(const float& f)
+    {
+      putTag(WM_LOG_FLOAT, &f, sizeof(f));
+    }
+
+    void putArg(const double& d)
+    {
+      float f = d;
+
+      putTag(WM_LOG_FLOAT, &f, sizeof(f));
+    }
+
+    template<typename T, typename std::enable_if<std::is_arithmetic<T>::value || std::is_enum<T>::value, int>::type = 0>
+    void putArg(const T& value)
+    {
+      if (std::is_signed<T>::value)
+      {
+        int32_t v = (int32_t) value;
+
+        putTag(WM_LOG_INT, &v, sizeof(v));
+      }
+      else
+      {
+        uint32_t v = (uint32_t) value;
+
+        putTag(WM_LOG_UINT, &v, sizeof(v));
+      }
+    }
+
+    ////////////////////////////////////////////////////
+
+    // Prints into a fixed buffer, truncating
+    class LinePrint : public Print
+    {
+      public:
+
+        LinePrint(char* buffer, const size_t& size) : _buffer(buffer), _size(size)
+        {
+        }
+
+        using Print::write;
+
+        size_t write(uint8_t c) override
+        {
+          if (length >= _size)
+            return 0;
+
+          _buffer[length++] = c;
+
+          return 1;
+        }
+
+        size_t length = 0;
+
+      private:
+
+        char*   _buffer;
+        size_t  _size;
+    };
+
+    // Formats the record as the synchronous LOG* macros print it, with its millis() after the mark
+    size_t format(const uint8_t* record, char* buffer, const size_t& size)
+    {
+      LinePrint out(buffer, size);
+      Header    header;
+
+      memcpy(&header, record, sizeof(header));
+
+      bool marked = header.flags & WM_LOG_MARKED;
+
+      if (marked)
+      {
+        out.print(F("[WM] "));
+        out.print(header.ms);
+        out.print(' ');
+      }
+
+      const uint8_t *p    = record + sizeof(header);
+      const uint8_t *end  = record + header.size;
+
+      while (p < end)
+      {
+        if (p > record + sizeof(header))
+          out.print(' ');
+
+        uint8_t tag = *p++;
+
+        if (tag == WM_LOG_STRING)
+        {
+          uint8_t len = *p++;
+
+          out.write(p, len);
+          p += len;
+
+          continue;
+        }
+
+        union
+        {
+          const __FlashStringHelper*  flash;
+          int32_t                     i;
+          uint32_t                    u;
+          float                       f;
+          char                        c;
+        } value;
+
+        size_t length = (tag == WM_LOG_FLASH) ? sizeof(void *) : ( (tag == WM_LOG_CHAR) ? 1 : 4 );
+
+        memcpy(&value, p, length);
+        p += length;
+
+        switch (tag)
+        {
+          case WM_LOG_FLASH:
+            out.print(value.flash);
+            break;
+
+          case WM_LOG_INT:
+            out.print(value.i);
+            break;
+
+          case WM_LOG_UINT:
+            out.print(value.u);
+            break;
+
+          case WM_LOG_FLOAT:
+            out.print(value.f);
+            break;
+
+          case WM_LOG_IP:
+            out.print(IPAddress(value.u));
+            break;
+
+          case WM_LOG_CHAR:
+            out.print(value.c);
+            break;
+        }
+      }
+
+      if (marked)
+      {
+        // Keep the end of line, even if truncated
+        out.length = std::min(out.length, size - 2);
+        out.print(F("\r\n"));
+      }
+
+      return out.length;
+    }
+};
+
+////////////////////////////////////////////////////
+
+// Defined in ESPAsync_WiFiManager-Impl.h
+extern ESPAsync_WMLog ESPAsync_WMlog;
+
+#endif    // ESPAsync_WMLog_h
@@ -40,6 +40,47 @@
 
 //////////////////////////////////////////
 
+ESPAsync_WMParamArena::ESPAsync_WMParamArena(const uint8_t& maxParams, const size_t& valueBytes)
+{
+  _maxParams  = maxParams;
+  _used       = maxParams * sizeof(ESPAsync_WMParameter*);
+  _size       = _used + valueBytes;
+  _block      = (uint8_t *) malloc(_size);
+
+  if (_block == NULL)
+  {
+    LOGERROR1(F("ParamArena: Can't allocate"), _size);
+  }
+  else
+  {
+    memset(_block, 0, _size);
+  }
+}
+
+//////////////////////////////////////////
+
+ESPAsync_WMParamArena::~ESPAsync_WMParamArena()
+{
+  if (_block != NULL)
+    free(_block);
+}
+
+//////////////////////////////////////////
+
+char* ESPAsync_WMParamArena::allocValue(const int& length)
+{
+  if ( (_block == NULL) || (length < 0) || (_used + length + 1 > _size) )
+    return NULL;
+
+  char *value = (char *) (_block + _used);
+
+  _used += length + 1;
+
+  return value;
+}
+
+//////////////////////////////////////////
+
 ESPAsync_WMParameter::ESPAsync_WMParameter(const char *custom)
 {
   _WMParam_data._id = NULL;
@@ -61,6 +102,15 @@ ESPAsync_WMParameter::ESPAsync_WMParameter(const char *id, const char *placehold
 
 //////////////////////////////////////////
 
+ESPAsync_WMParameter::ESPAsync_WMParameter(ESPAsync_WMParamArena& arena, const char *id, const char *placeholder,
+                                           const char *defaultValue, const int& length, const char *custom,
+                                           const int& labelPlacement)
+{
+  init(id, placeholder, defaultValue, length, custom, labelPlacement, &arena);
+}
+
+//////////////////////////////////////////
+
 // KH, using struct
 ESPAsync_WMParameter::ESPAsync_WMParameter(const WMParam_Data& WMParam_data)
 {
@@ -71,14 +121,24 @@ ESPAsync_WMParameter::ESPAsync_WMParameter(const WMParam_Data& WMParam_data)
 //////////////////////////////////////////
 
 void ESPAsync_WMParameter::init(const char *id, const char *placeholder, const char *defaultValue,
-                                const int& length, const char *custom, const int& labelPlacement)
+                                const int& length, const char *custom, const int& labelPlacement,
+                                ESPAsync_WMParamArena* arena)
 {
   _WMParam_data._id = id;
   _WMParam_data._placeholder = placeholder;
   _WMParam_data._length = length;
   _WMParam_data._labelPlacement = labelPlacement;
 
-  _WMParam_data._value = new char[_WMParam_data._length + 1];
+  _WMParam_data._value = arena ? arena->allocValue(_WMParam_data._length) : NULL;
+  _inArena = (_WMParam_data._value != NULL);
+
+  if (arena && !_inArena)
+  {
+    LOGWARN1(F("ParamArena full, on the heap :"), id);
+  }
+
+  if (!_inArena)
+    _WMParam_data._value = new char[_WMParam_data._length + 1];
 
   if (_WMParam_data._value != NULL)
   {
@@ -97,7 +157,7 @@ void ESPAsync_WMParameter::init(const char *id, const char *placeholder, const c
 
 ESPAsync_WMParameter::~ESPAsync_WMParameter()
 {
-  if (_WMParam_data._value != NULL)
+  if ( (_WMParam_data._value != NULL) && !_inArena )
   {
     delete[] _WMParam_data._value;
   }
@@ -166,299 +226,2008 @@ const char* ESPAsync_WMParameter::getCustomHTML()
 
 //////////////////////////////////////////
 
-/**
-   [getParameters description]
-   @access public
-*/
-ESPAsync_WMParameter** ESPAsync_WiFiManager::getParameters()
+ESPAsync_WMPageStream::ESPAsync_WMPageStream()
 {
-  return _params;
 }
 
-//////////////////////////////////////////
 //////////////////////////////////////////
 
-/**
-   [getParametersCount description]
-   @access public
-*/
-int ESPAsync_WiFiManager::getParametersCount()
+void ESPAsync_WMPageStream::addP(PGM_P text)
 {
-  return _paramsCount;
+  Section section = { WM_STREAM_PROGMEM, text, 0, strlen_P(text) };
+
+  _sections.push_back(section);
 }
 
 //////////////////////////////////////////
 
-char* ESPAsync_WiFiManager::getRFC952_hostname(const char* iHostname)
+void ESPAsync_WMPageStream::add(const __FlashStringHelper* text)
 {
-  memset(RFC952_hostname, 0, sizeof(RFC952_hostname));
-
-  size_t len = (RFC952_HOSTNAME_MAXLEN < strlen(iHostname)) ? RFC952_HOSTNAME_MAXLEN : strlen(iHostname);
-
-  size_t j = 0;
-
-  for (size_t i = 0; i < len - 1; i++)
-  {
-    if (isalnum(iHostname[i]) || iHostname[i] == '-')
-    {
-      RFC952_hostname[j] = iHostname[i];
-      j++;
-    }
-  }
-
-  // no '-' as last char
-  if (isalnum(iHostname[len - 1]) || (iHostname[len - 1] != '-'))
-    RFC952_hostname[j] = iHostname[len - 1];
-
-  return RFC952_hostname;
+  addP((PGM_P) text);
 }
 
 //////////////////////////////////////////
 
-ESPAsync_WiFiManager::ESPAsync_WiFiManager(AsyncWebServer * webserver, AsyncDNSServer *dnsserver, const char *iHostname)
+void ESPAsync_WMPageStream::add(const String& text)
 {
-
-  server    = webserver;
-  dnsServer = dnsserver;
-
-  wifiSSIDs     = NULL;
-
-  // KH
-  wifiSSIDscan  = true;
-  //wifiSSIDscan  = false;
-  //////
-
-  _modeless     = false;
-  shouldscan    = true;
-
-#if USE_DYNAMIC_PARAMS
-  _max_params = WIFI_MANAGER_MAX_PARAMS;
-  _params = (ESPAsync_WMParameter**)malloc(_max_params * sizeof(ESPAsync_WMParameter*));
-#endif
-
-  //WiFi not yet started here, must call WiFi.mode(WIFI_STA) and modify function WiFiGenericClass::mode(wifi_mode_t m) !!!
-  WiFi.mode(WIFI_STA);
-
-  if (iHostname[0] == 0)
+  // Merge with the previous section if it's also a copied text
+  if ( !_sections.empty() && (_sections.back().type == WM_STREAM_TEXT) )
   {
-#ifdef ESP8266
-    String _hostname = "ESP8266-" + String(ESP.getChipId(), HEX);
-#else    //ESP32
-    String _hostname = "ESP32-" + String(ESP_getChipId(), HEX);
-#endif
-
-    _hostname.toUpperCase();
-
-    getRFC952_hostname(_hostname.c_str());
-
+    _sections.back().length += text.length();
   }
   else
   {
-    // Prepare and store the hostname only not NULL
-    getRFC952_hostname(iHostname);
-  }
-
-  LOGWARN1(F("RFC925 Hostname ="), RFC952_hostname);
+    Section section = { WM_STREAM_TEXT, NULL, _text.length(), text.length() };
 
-  setHostname();
+    _sections.push_back(section);
+  }
 
-  networkIndices = NULL;
+  _text += text;
 }
 
 //////////////////////////////////////////
 
-ESPAsync_WiFiManager::~ESPAsync_WiFiManager()
+void ESPAsync_WMPageStream::add(const char* text)
 {
-#if USE_DYNAMIC_PARAMS
-
-  if (_params != NULL)
-  {
-    LOGINFO(F("freeing allocated params!"));
+  if (text && text[0])
+    add(String(text));
+}
 
-    free(_params);
-  }
+//////////////////////////////////////////
 
-#endif
+void ESPAsync_WMPageStream::addItems(const ItemGenerator& generator)
+{
+  Section section = { WM_STREAM_ITEMS, NULL, _generators.size(), 0 };
 
-  if (networkIndices)
-  {
-    free(networkIndices); //indices array no longer required so free memory
-  }
+  _generators.push_back(generator);
+  _sections.push_back(section);
 }
 
 //////////////////////////////////////////
 
-#if USE_DYNAMIC_PARAMS
-  bool ESPAsync_WiFiManager::addParameter(ESPAsync_WMParameter *p)
-#else
-  void ESPAsync_WiFiManager::addParameter(ESPAsync_WMParameter *p)
-#endif
+size_t ESPAsync_WMPageStream::fill(uint8_t *buffer, const size_t& maxLen)
 {
-#if USE_DYNAMIC_PARAMS
+  size_t written = 0;
 
-  if (_paramsCount == _max_params)
+  while ( (written < maxLen) && (_section < _sections.size()) )
   {
-    // rezise the params array
-    _max_params += WIFI_MANAGER_MAX_PARAMS;
+    Section& section = _sections[_section];
 
-    LOGINFO1(F("Increasing _max_params to:"), _max_params);
+    const char  *source;
+    size_t      available;
 
-    ESPAsync_WMParameter** new_params = (ESPAsync_WMParameter**)realloc(_params,
-                                                                        _max_params * sizeof(ESPAsync_WMParameter*));
+    if (section.type == WM_STREAM_ITEMS)
+    {
+      if (_sectionOffset >= _item.length())
+      {
+        // Current item fully sent, render the next one
+        _item           = "";
+        _sectionOffset  = 0;
 
-    if (new_params != NULL)
+        if (!_generators[section.offset](_item, _itemIndex++))
+        {
+          _item       = "";
+          _itemIndex  = 0;
+          _section++;
+        }
+
+        continue;
+      }
+
+      source    = _item.c_str() + _sectionOffset;
+      available = _item.length() - _sectionOffset;
+    }
+    else if (section.type == WM_STREAM_TEXT)
     {
-      _params = new_params;
+      source    = _text.c_str() + section.offset + _sectionOffset;
+      available = section.length - _sectionOffset;
     }
     else
     {
-      LOGINFO(F("ERROR: failed to realloc params, size not increased!"));
+      source    = section.text + _sectionOffset;
+      available = section.length - _sectionOffset;
+    }
 
-      return false;
+    size_t len = std::min(available, maxLen - written);
+
+    if (section.type == WM_STREAM_PROGMEM)
+      memcpy_P(buffer + written, source, len);
+    else
+      memcpy(buffer + written, source, len);
+
+    written         += len;
+    _sectionOffset  += len;
+
+    if ( (section.type != WM_STREAM_ITEMS) && (_sectionOffset >= section.length) )
+    {
+      _section++;
+      _sectionOffset = 0;
     }
   }
 
-  _params[_paramsCount] = p;
-  _paramsCount++;
+  _bytesSent += written;
 
-  LOGINFO1(F("Adding parameter"), p->getID());
+  return written;
+}
 
-  return true;
+//////////////////////////////////////////
 
-#else
+bool ESPAsync_WMPageStream::isStatic() const
+{
+  return _generators.empty();
+}
 
-  // Danger here. Better to use Tzapu way here
-  if (_paramsCount < (WIFI_MANAGER_MAX_PARAMS))
-  {
-    _params[_paramsCount] = p;
-    _paramsCount++;
+//////////////////////////////////////////
 
-    LOGINFO1(F("Adding parameter"), p->getID());
-  }
-  else
+size_t ESPAsync_WMPageStream::length() const
+{
+  size_t total = 0;
+
+  for (const Section& section : _sections)
   {
-    LOGINFO("Can't add parameter. Full");
+    total += section.length;
   }
 
-#endif
+  return total;
 }
 
 //////////////////////////////////////////
 
-void ESPAsync_WiFiManager::setupConfigPortal()
+// Static pages only, items are not rendered here
+size_t ESPAsync_WMPageStream::read(const size_t& index, uint8_t *buffer, const size_t& maxLen) const
 {
-  stopConfigPortal = false; //Signal not to close config portal
+  size_t written  = 0;
+  size_t start    = 0;
 
-  /*This library assumes autoconnect is set to 1. It usually is
-    but just in case check the setting and turn on autoconnect if it is off.
-    Some useful discussion at https://github.com/esp8266/Arduino/issues/1615*/
-  if (WiFi.getAutoConnect() == 0)
-    WiFi.setAutoConnect(1);
+  for (const Section& section : _sections)
+  {
+    if (written >= maxLen)
+      break;
 
-#if !( USING_ESP32_S2 || USING_ESP32_C3 )
-#ifdef ESP8266
-  // KH, mod for Async
-  server->reset();
-#else   //ESP32
-  server->reset();
-#endif
+    size_t end = start + section.length;
 
-  if (!dnsServer)
-    dnsServer = new AsyncDNSServer;
+    if ( (section.type != WM_STREAM_ITEMS) && (index + written < end) )
+    {
+      size_t offset = index + written - start;
+      size_t len    = std::min(section.length - offset, maxLen - written);
 
-#endif    // ( USING_ESP32_S2 || USING_ESP32_C3 )
+      if (section.type == WM_STREAM_PROGMEM)
+        memcpy_P(buffer + written, section.text + offset, len);
+      else
+        memcpy(buffer + written, _text.c_str() + section.offset + offset, len);
 
-  // optional soft ip config
-  // Must be put here before dns server start to take care of the non-default ConfigPortal AP IP.
-  // Check (https://github.com/khoih-prog/ESP_WiFiManager/issues/58)
-  if (_WiFi_AP_IPconfig._ap_static_ip)
-  {
-    LOGWARN3(F("Custom AP IP/GW/Subnet = "), _WiFi_AP_IPconfig._ap_static_ip, _WiFi_AP_IPconfig._ap_static_gw,
-             _WiFi_AP_IPconfig._ap_static_sn);
+      written += len;
+    }
 
-    WiFi.softAPConfig(_WiFi_AP_IPconfig._ap_static_ip, _WiFi_AP_IPconfig._ap_static_gw, _WiFi_AP_IPconfig._ap_static_sn);
+    start = end;
   }
 
-  /* Setup the DNS server redirecting all the domains to the apIP */
-  if (dnsServer)
-  {
-    dnsServer->setErrorReplyCode(AsyncDNSReplyCode::NoError);
-
-    // AsyncDNSServer started with "*" domain name, all DNS requests will be passsed to WiFi.softAPIP()
-    if (! dnsServer->start(DNS_PORT, "*", WiFi.softAPIP()))
-    {
-      // No socket available
-      LOGERROR(F("Can't start DNS Server. No available socket"));
-    }
-  }
+  return written;
+}
 
-  _configPortalStart = millis();
+//////////////////////////////////////////
 
-  LOGWARN1(F("\nConfiguring AP SSID ="), _apName);
+// Nesting levels past the 32nd are still written, their commas are not tracked
+#define WM_JSON_LEVEL(depth)      ( ((depth) < 32) ? (1UL << (depth)) : 0 )
 
-  if (_apPassword != NULL)
-  {
-    if (strlen(_apPassword) < 8 || strlen(_apPassword) > 63)
-    {
-      // fail passphrase to short or long!
-      LOGERROR(F("Invalid AccessPoint password. Ignoring"));
+ESPAsync_WMJsonWriter::ESPAsync_WMJsonWriter(String& out, const bool& separated) : _out(out)
+{
+  _nonEmpty = separated ? 1 : 0;
+}
 
-      _apPassword = NULL;
-    }
+//////////////////////////////////////////
 
-    LOGWARN1(F("AP PWD ="), _apPassword);
-  }
+void ESPAsync_WMJsonWriter::separate(const __FlashStringHelper* key)
+{
+  if (_nonEmpty & WM_JSON_LEVEL(_depth))
+    _out += ',';
 
-  // KH, To enable dynamic/random channel
-  static int channel;
+  _nonEmpty |= WM_JSON_LEVEL(_depth);
 
-  // Use random channel if  _WiFiAPChannel == 0
-  if (_WiFiAPChannel == 0)
-    channel = (_configPortalStart % MAX_WIFI_CHANNEL) + 1;
-  else
-    channel = _WiFiAPChannel;
+  if (key)
+  {
+    _out += '"';
+    _out += key;
+    _out += F("\":");
+  }
+}
 
-  LOGWARN1(F("AP Channel ="), channel);
+//////////////////////////////////////////
 
-  WiFi.softAP(_apName, _apPassword, channel);
+ESPAsync_WMJsonWriter& ESPAsync_WMJsonWriter::beginObject(const __FlashStringHelper* key)
+{
+  separate(key);
 
-  delay(500); // Without delay I've seen the IP address blank
+  _out += '{';
+  _depth++;
+  _nonEmpty &= ~WM_JSON_LEVEL(_depth);
 
-  LOGWARN1(F("AP IP address ="), WiFi.softAPIP());
+  return *this;
+}
 
-  /* Setup web pages: root, wifi config pages, SO captive portal detectors and not found. */
+//////////////////////////////////////////
 
-  server->on("/",         std::bind(&ESPAsync_WiFiManager::handleRoot,        this,
-                                    std::placeholders::_1)).setFilter(ON_AP_FILTER);
-  server->on("/wifi",     std::bind(&ESPAsync_WiFiManager::handleWifi,        this,
-                                    std::placeholders::_1)).setFilter(ON_AP_FILTER);
-  server->on("/wifisave", std::bind(&ESPAsync_WiFiManager::handleWifiSave,    this,
-                                    std::placeholders::_1)).setFilter(ON_AP_FILTER);
-  server->on("/close",    std::bind(&ESPAsync_WiFiManager::handleServerClose, this,
-                                    std::placeholders::_1)).setFilter(ON_AP_FILTER);
-  server->on("/i",        std::bind(&ESPAsync_WiFiManager::handleInfo,        this,
-                                    std::placeholders::_1)).setFilter(ON_AP_FILTER);
-  server->on("/r",        std::bind(&ESPAsync_WiFiManager::handleReset,       this,
-                                    std::placeholders::_1)).setFilter(ON_AP_FILTER);
-  server->on("/state",    std::bind(&ESPAsync_WiFiManager::handleState,       this,
-                                    std::placeholders::_1)).setFilter(ON_AP_FILTER);
-  server->on("/scan",     std::bind(&ESPAsync_WiFiManager::handleScan,        this,
-                                    std::placeholders::_1)).setFilter(ON_AP_FILTER);
-  //Microsoft captive portal. Maybe not needed. Might be handled by notFound handler.
-  server->on("/fwlink",   std::bind(&ESPAsync_WiFiManager::handleRoot,        this,
-                                    std::placeholders::_1)).setFilter(ON_AP_FILTER);
-  server->onNotFound (std::bind(&ESPAsync_WiFiManager::handleNotFound,        this, std::placeholders::_1));
+ESPAsync_WMJsonWriter& ESPAsync_WMJsonWriter::endObject()
+{
+  if (_depth > 0)
+    _depth--;
 
-  server->begin(); // Web server start
+  _out += '}';
 
-  LOGWARN(F("HTTP server started"));
+  return *this;
 }
 
 //////////////////////////////////////////
 
-bool ESPAsync_WiFiManager::autoConnect()
+ESPAsync_WMJsonWriter& ESPAsync_WMJsonWriter::beginArray(const __FlashStringHelper* key)
 {
-#ifdef ESP8266
+  separate(key);
+
+  _out += '[';
+  _depth++;
+  _nonEmpty &= ~WM_JSON_LEVEL(_depth);
+
+  return *this;
+}
+
+//////////////////////////////////////////
+
+ESPAsync_WMJsonWriter& ESPAsync_WMJsonWriter::endArray()
+{
+  if (_depth > 0)
+    _depth--;
+
+  _out += ']';
+
+  return *this;
+}
+
+//////////////////////////////////////////
+
+ESPAsync_WMJsonWriter& ESPAsync_WMJsonWriter::add(const __FlashStringHelper* key, const char* value)
+{
+  separate(key);
+
+  if (value)
+    addString(_out, value, strlen(value));
+  else
+    _out += F("null");
+
+  return *this;
+}
+
+//////////////////////////////////////////
+
+ESPAsync_WMJsonWriter& ESPAsync_WMJsonWriter::add(const __FlashStringHelper* key, const String& value)
+{
+  separate(key);
+  addString(_out, value.c_str(), value.length());
+
+  return *this;
+}
+
+//////////////////////////////////////////
+
+ESPAsync_WMJsonWriter& ESPAsync_WMJsonWriter::add(const __FlashStringHelper* key, const bool& value)
+{
+  separate(key);
+
+  if (value)
+    _out += F("true");
+  else
+    _out += F("false");
+
+  return *this;
+}
+
+//////////////////////////////////////////
+
+ESPAsync_WMJsonWriter& ESPAsync_WMJsonWriter::add(const __FlashStringHelper* key, const int& value)
+{
+  separate(key);
+
+  _out += value;
+
+  return *this;
+}
+
+//////////////////////////////////////////
+
+void ESPAsync_WMJsonWriter::addString(String& out, const char* text, const size_t& length)
+{
+  static const char hexDigits[] = "0123456789abcdef";
+
+  // Enough unless something has to be escaped, which SSIDs seldom need
+  out.reserve(out.length() + length + 2);
+
+  out += '"';
+
+  for (size_t i = 0; i < length; i++)
+  {
+    uint8_t c = (uint8_t) text[i];
+
+    if ( (c == '"') || (c == '\\') )
+    {
+      out += '\\';
+      out += (char) c;
+    }
+    else if (c == '\n')
+    {
+      out += F("\\n");
+    }
+    else if (c == '\r')
+    {
+      out += F("\\r");
+    }
+    else if (c == '\t')
+    {
+      out += F("\\t");
+    }
+    else if (c < 0x20)
+    {
+      out += F("\\u00");
+      out += hexDigits[c >> 4];
+      out += hexDigits[c & 0x0F];
+    }
+    else
+    {
+      // UTF-8 sequences are copied as is
+      out += (char) c;
+    }
+  }
+
+  out += '"';
+}
+
+//////////////////////////////////////////
+
+ESPAsync_WMTemplate::ESPAsync_WMTemplate(PGM_P text, const char* slotNames)
+{
+  _text       = text;
+  _slotNames  = slotNames;
+}
+
+//////////////////////////////////////////
+
+ESPAsync_WMTemplate::~ESPAsync_WMTemplate()
+{
+  if (_segments)
+    delete [] _segments;
+}
+
+//////////////////////////////////////////
+
+// Position of the placeholder name _text[nameOffset, nameOffset + nameLength) in _slotNames, -1 if not there
+int8_t ESPAsync_WMTemplate::slotIndex(const size_t& nameOffset, const size_t& nameLength)
+{
+  int8_t      index = 0;
+  const char  *name = _slotNames;
+
+  while (true)
+  {
+    const char  *end  = strchr(name, ',');
+    size_t      len   = end ? (size_t) (end - name) : strlen(name);
+
+    if (len == nameLength)
+    {
+      size_t i = 0;
+
+      while ( (i < len) && (name[i] == (char) pgm_read_byte(_text + nameOffset + i)) )
+        i++;
+
+      if (i == len)
+        return index;
+    }
+
+    if (!end)
+      return -1;
+
+    name = end + 1;
+    index++;
+  }
+}
+
+//////////////////////////////////////////
+
+bool ESPAsync_WMTemplate::compile()
+{
+  size_t textLength = strlen_P(_text);
+
+  if (textLength > 0xFFFF)
+  {
+    LOGERROR1(F("Template too long, len ="), textLength);
+    return false;
+  }
+
+  size_t count = 0;
+
+  auto store = [&](const size_t& offset, const size_t& length, const int8_t& slot)
+  {
+    if (_segments)
+    {
+      _segments[count].offset = offset;
+      _segments[count].length = length;
+      _segments[count].slot   = slot;
+    }
+
+    if (slot < 0)
+      _literalLength += length;
+
+    count++;
+  };
+
+  // First pass only counts the segments, second pass stores them
+  for (uint8_t pass = 0; pass < 2; pass++)
+  {
+    size_t pos          = 0;
+    size_t literalStart = 0;
+
+    count           = 0;
+    _literalLength  = 0;
+
+    while (pos < textLength)
+    {
+      char    c         = pgm_read_byte(_text + pos);
+      size_t  delimiter = 0;    // 1 for {name}, 2 for [[name]]
+
+      if (c == '{')
+        delimiter = 1;
+      else if ( (c == '[') && (pos + 1 < textLength) && (pgm_read_byte(_text + pos + 1) == '[') )
+        delimiter = 2;
+
+      if (delimiter == 0)
+      {
+        pos++;
+        continue;
+      }
+
+      size_t nameOffset = pos + delimiter;
+      size_t nameEnd    = nameOffset;
+
+      while ( (nameEnd < textLength) && isalnum(pgm_read_byte(_text + nameEnd)) )
+        nameEnd++;
+
+      char    closing = (delimiter == 1) ? '}' : ']';
+      size_t  closed  = 0;
+
+      while ( (closed < delimiter) && (nameEnd + closed < textLength) && (pgm_read_byte(_text + nameEnd + closed) == closing) )
+        closed++;
+
+      int8_t slot = -1;
+
+      if ( (closed == delimiter) && (nameEnd > nameOffset) )
+        slot = slotIndex(nameOffset, nameEnd - nameOffset);
+
+      if (slot < 0)
+      {
+        // Not one of our placeholders, keep it as literal text
+        pos++;
+        continue;
+      }
+
+      if (pos > literalStart)
+        store(literalStart, pos - literalStart, -1);
+
+      store(pos, nameEnd + delimiter - pos, slot);
+
+      pos           = nameEnd + delimiter;
+      literalStart  = pos;
+    }
+
+    if (textLength > literalStart)
+      store(literalStart, textLength - literalStart, -1);
+
+    if (pass == 0)
+    {
+      if (count > 0xFF)
+      {
+        LOGERROR1(F("Too many template segments ="), count);
+        return false;
+      }
+
+      // At least one, so that an empty template is still marked as compiled
+      _segments = new Segment[count ? count : 1];
+    }
+  }
+
+  _segmentCount = count;
+
+  LOGDEBUG3(F("Template compiled, len ="), textLength, F(", segments ="), _segmentCount);
+
+  return true;
+}
+
+//////////////////////////////////////////
+
+void ESPAsync_WMTemplate::appendLiteral(String& out, const Segment& segment)
+{
+  // PROGMEM may not be byte addressable, copy through a small buffer
+  char    buffer[65];
+  size_t  offset    = segment.offset;
+  size_t  remaining = segment.length;
+
+  while (remaining > 0)
+  {
+    size_t len = std::min(remaining, sizeof(buffer) - 1);
+
+    memcpy_P(buffer, _text + offset, len);
+    buffer[len] = 0;
+
+    out += buffer;
+
+    offset    += len;
+    remaining -= len;
+  }
+}
+
+//////////////////////////////////////////
+
+void ESPAsync_WMTemplate::render(String& out, const char* const values[])
+{
+  if ( (_segments == NULL) && !compile() )
+  {
+    out += FPSTR(_text);
+    return;
+  }
+
+  // One reservation for the whole rendering
+  size_t length = out.length() + _literalLength;
+
+  for (uint8_t i = 0; i < _segmentCount; i++)
+  {
+    if ( (_segments[i].slot >= 0) && values[_segments[i].slot] )
+      length += strlen(values[_segments[i].slot]);
+  }
+
+  out.reserve(length);
+
+  for (uint8_t i = 0; i < _segmentCount; i++)
+  {
+    const Segment& segment = _segments[i];
+
+    if (segment.slot < 0)
+      appendLiteral(out, segment);
+    else if (values[segment.slot])
+      out += values[segment.slot];
+  }
+}
+
+//////////////////////////////////////////
+
+#ifdef ESP32
+
+volatile uint32_t   ESPAsync_WMConnectWaiter::_gotIPEvents          = 0;
+volatile uint32_t   ESPAsync_WMConnectWaiter::_disconnectedEvents   = 0;
+volatile uint32_t   ESPAsync_WMConnectWaiter::_connectedEvents      = 0;
+wifi_event_id_t     ESPAsync_WMConnectWaiter::_eventID              = 0;
+SemaphoreHandle_t   ESPAsync_WMConnectWaiter::_signal               = NULL;
+
+#endif
+
+//////////////////////////////////////////
+
+ESPAsync_WMConnectWaiter::ESPAsync_WMConnectWaiter()
+{
+}
+
+//////////////////////////////////////////
+
+ESPAsync_WMConnectWaiter::~ESPAsync_WMConnectWaiter()
+{
+  unsubscribe();
+}
+
+//////////////////////////////////////////
+
+void ESPAsync_WMConnectWaiter::subscribe()
+{
+#ifdef ESP8266
+  // Called from the SDK, only set flags here
+  _gotIPHandler = WiFi.onStationModeGotIP([this](const WiFiEventStationModeGotIP & event)
+  {
+    (void) event;
+
+    _gotIP = true;
+  });
+
+  _disconnectedHandler = WiFi.onStationModeDisconnected([this](const WiFiEventStationModeDisconnected & event)
+  {
+    (void) event;
+
+    _disconnected = true;
+  });
+
+  _connectedHandler = WiFi.onStationModeConnected([this](const WiFiEventStationModeConnected & event)
+  {
+    (void) event;
+
+    _joined = true;
+  });
+#else
+  if (_signal == NULL)
+    _signal = xSemaphoreCreateBinary();
+
+  if (_eventID == 0)
+  {
+    // Called from the WiFi event task, only count and wake up wait(). Nothing of a waiter is touched here
+    _eventID = WiFi.onEvent([](WiFiEvent_t event, WiFiEventInfo_t info)
+    {
+      (void) info;
+
+      if (event == WM_EVENT_STA_GOT_IP)
+        _gotIPEvents++;
+      else if (event == WM_EVENT_STA_DISCONNECTED)
+        _disconnectedEvents++;
+      else if (event == WM_EVENT_STA_CONNECTED)
+      {
+        // Nothing to wake up for, the IP comes next
+        _connectedEvents++;
+
+        return;
+      }
+      else
+        return;
+
+      xSemaphoreGive(_signal);
+    });
+  }
+#endif
+}
+
+//////////////////////////////////////////
+
+void ESPAsync_WMConnectWaiter::unsubscribe()
+{
+#ifdef ESP8266
+  _gotIPHandler.reset();
+  _disconnectedHandler.reset();
+  _connectedHandler.reset();
+#endif
+}
+
+//////////////////////////////////////////
+
+void ESPAsync_WMConnectWaiter::begin(const unsigned long& timeout, const ConnectCallback& callback)
+{
+  _gotIP        = false;
+  _disconnected = false;
+  _joined       = false;
+
+  _pending      = true;
+  _status       = WL_IDLE_STATUS;
+  _start        = millis();
+  _timeout      = timeout;
+  _callback     = callback;
+
+  subscribe();
+
+#ifdef ESP32
+  // Only the events from now on
+  _gotIPSeen        = _gotIPEvents;
+  _disconnectedSeen = _disconnectedEvents;
+  _connectedSeen    = _connectedEvents;
+#endif
+
+  // Already connected, or got the IP before we subscribed
+  if (WiFi.status() == WL_CONNECTED)
+    _gotIP = true;
+}
+
+//////////////////////////////////////////
+
+void ESPAsync_WMConnectWaiter::complete(const wl_status_t& status)
+{
+  _pending  = false;
+  _status   = status;
+
+  unsubscribe();
+
+#if USE_WM_METRICS
+  ESPAsync_WMmetrics.connect(status, millis() - _start);
+#endif
+
+  if (_callback)
+  {
+    // The callback may start a new attempt
+    ConnectCallback callback = _callback;
+
+    _callback = nullptr;
+    callback(status);
+  }
+}
+
+//////////////////////////////////////////
+
+bool ESPAsync_WMConnectWaiter::poll()
+{
+  if (!_pending)
+    return true;
+
+#ifdef ESP32
+  if (_gotIPEvents != _gotIPSeen)
+    _gotIP = true;
+
+  if (_disconnectedEvents != _disconnectedSeen)
+  {
+    _disconnectedSeen = _disconnectedEvents;
+    _disconnected     = true;
+  }
+#endif
+
+  if (_gotIP)
+  {
+    LOGWARN1(F("Connected after waiting (ms) :"), millis() - _start);
+
+    complete(WiFi.status());
+
+    return true;
+  }
+
+  // Only look at the status when the station dropped. It keeps retrying, unless the password is wrong
+  if (_disconnected)
+  {
+    _disconnected = false;
+
+    wl_status_t status = WiFi.status();
+
+#if ( ESP8266 && (USING_ESP8266_CORE_VERSION >= 30000) )
+    if ( (status == WL_CONNECT_FAILED) || (status == WL_WRONG_PASSWORD) )
+#else
+    if (status == WL_CONNECT_FAILED)
+#endif
+    {
+      LOGERROR1(F("Connection failed after waiting (ms) :"), millis() - _start);
+
+      complete(status);
+
+      return true;
+    }
+  }
+
+  if (millis() - _start >= _timeout)
+  {
+    LOGERROR(F("Connection timed out"));
+
+    complete(WiFi.status());
+
+    return true;
+  }
+
+  return false;
+}
+
+//////////////////////////////////////////
+
+wl_status_t ESPAsync_WMConnectWaiter::wait(const std::function<void()>& idle)
+{
+  while (!poll())
+  {
+    if (idle)
+      idle();
+
+#if USE_WM_DEFERRED_LOG
+    ESPAsync_WMlog.drain(DBG_PORT_ESP_WM);
+#endif
+
+#ifdef ESP8266
+    // Events are only delivered while we yield
+    delay(1);
+#else
+    unsigned long elapsed = millis() - _start;
+    unsigned long ms      = (elapsed < _timeout) ? (_timeout - elapsed) : 1;
+
+    // Keep calling idle regularly
+    if (idle && (ms > 10))
+      ms = 10;
+
+    xSemaphoreTake(_signal, pdMS_TO_TICKS(ms) + 1);
+#endif
+  }
+
+  return _status;
+}
+
+//////////////////////////////////////////
+
+bool ESPAsync_WMConnectWaiter::joined()
+{
+#ifdef ESP32
+  if (_connectedEvents != _connectedSeen)
+    _joined = true;
+#endif
+
+  // Got the IP, or already connected at begin()
+  return (_joined || _gotIP);
+}
+
+//////////////////////////////////////////
+
+void ESPAsync_WMConnectWaiter::cancel()
+{
+  _pending  = false;
+  _callback = nullptr;
+
+  unsubscribe();
+}
+
+//////////////////////////////////////////
+
+#if USE_WM_DEFERRED_LOG
+
+ESPAsync_WMLog ESPAsync_WMlog;
+
+#endif
+
+//////////////////////////////////////////
+
+#if USE_WM_KNOWN_NETWORKS
+
+ESPAsync_WMKnownNetworks::ESPAsync_WMKnownNetworks(fs::FS& fileSystem, const char* path)
+  : _store(fileSystem, path, sizeof(Record))
+{
+  memset(&_record, 0, sizeof(_record));
+}
+
+//////////////////////////////////////////
+
+bool ESPAsync_WMKnownNetworks::load()
+{
+  uint16_t version = 0;
+
+  memset(&_record, 0, sizeof(_record));
+  _dirty = false;
+
+  // Only the used part of the table is saved
+  if ( (_store.load(&_record, sizeof(_record), version) < offsetof(Record, networks)) ||
+       (version != WM_KNOWN_NETWORKS_VERSION) )
+  {
+    memset(&_record, 0, sizeof(_record));
+
+    return false;
+  }
+
+  _record.count = std::min(_record.count, (uint8_t) WM_KNOWN_NETWORKS_SIZE);
+
+  LOGINFO1(F("Known networks ="), _record.count);
+
+  return true;
+}
+
+//////////////////////////////////////////
+
+bool ESPAsync_WMKnownNetworks::save()
+{
+  if (!_dirty)
+    return true;
+
+  size_t length = offsetof(Record, networks) + _record.count * sizeof(WM_KnownNetwork);
+
+  if (!_store.save(&_record, length, WM_KNOWN_NETWORKS_VERSION))
+    return false;
+
+  _dirty = false;
+
+  return true;
+}
+
+//////////////////////////////////////////
+
+int ESPAsync_WMKnownNetworks::find(const char* ssid)
+{
+  for (uint8_t i = 0; i < _record.count; i++)
+  {
+    if (strcmp(_record.networks[i].ssid, ssid) == 0)
+      return i;
+  }
+
+  return -1;
+}
+
+//////////////////////////////////////////
+
+// Higher score first, then the most recently connected
+bool ESPAsync_WMKnownNetworks::isBetter(const WM_KnownNetwork& a, const WM_KnownNetwork& b)
+{
+  if (score(a) != score(b))
+    return (score(a) > score(b));
+
+  return (a.lastConnected > b.lastConnected);
+}
+
+//////////////////////////////////////////
+
+bool ESPAsync_WMKnownNetworks::add(const char* ssid, const char* pass)
+{
+  if ( !ssid || (ssid[0] == 0) || (strlen(ssid) >= WM_KNOWN_SSID_LEN) || (strlen(pass) >= WM_KNOWN_PASS_LEN) )
+    return false;
+
+  int index = find(ssid);
+
+  if (index >= 0)
+  {
+    WM_KnownNetwork& network = _record.networks[index];
+
+    if (strcmp(network.pass, pass) != 0)
+    {
+      strcpy(network.pass, pass);
+
+      // Failures with the former password don't count anymore
+      network.failures  = 0;
+      _dirty            = true;
+    }
+
+    return true;
+  }
+
+  if (_record.count < WM_KNOWN_NETWORKS_SIZE)
+  {
+    index = _record.count++;
+  }
+  else
+  {
+    index = 0;
+
+    for (uint8_t i = 1; i < _record.count; i++)
+    {
+      if (isBetter(_record.networks[index], _record.networks[i]))
+        index = i;
+    }
+
+    LOGWARN1(F("Known networks full, forget"), _record.networks[index].ssid);
+  }
+
+  WM_KnownNetwork& network = _record.networks[index];
+
+  memset(&network, 0, sizeof(network));
+
+  strcpy(network.ssid, ssid);
+  strcpy(network.pass, pass);
+
+  _dirty = true;
+
+  return true;
+}
+
+//////////////////////////////////////////
+
+bool ESPAsync_WMKnownNetworks::remove(const char* ssid)
+{
+  int index = find(ssid);
+
+  if (index < 0)
+    return false;
+
+  memmove(&_record.networks[index], &_record.networks[index + 1], (_record.count - index - 1) * sizeof(WM_KnownNetwork));
+
+  _record.count--;
+  _dirty = true;
+
+  return true;
+}
+
+//////////////////////////////////////////
+
+const char* ESPAsync_WMKnownNetworks::password(const char* ssid)
+{
+  int index = find(ssid);
+
+  return (index < 0) ? NULL : _record.networks[index].pass;
+}
+
+//////////////////////////////////////////
+
+void ESPAsync_WMKnownNetworks::connected()
+{
+  int index = find(WiFi.SSID().c_str());
+
+  if (index < 0)
+    return;
+
+  WM_KnownNetwork& network = _record.networks[index];
+
+  memcpy(network.bssid, WiFi.BSSID(), sizeof(network.bssid));
+
+  network.channel       = WiFi.channel();
+  network.failures      = 0;
+  network.lastConnected = ++_record.connections;
+
+  if (network.successes < 0xFFFF)
+    network.successes++;
+
+  _dirty = true;
+}
+
+//////////////////////////////////////////
+
+wl_status_t ESPAsync_WMKnownNetworks::connect(const unsigned long& timeout, const std::function<void()>& idle)
+{
+  if (_record.count == 0)
+    return WL_NO_SSID_AVAIL;
+
+  Candidate candidates[WM_KNOWN_NETWORKS_SIZE];
+  uint8_t   count = 0;
+
+  wifi_ssid_count_t n = WiFi.scanNetworks(false, true);
+
+  String    ssid;
+  uint8_t   encryptionType;
+  int32_t   RSSI;
+  uint8_t   *bssid;
+  int32_t   channel;
+  bool      isHidden;
+
+  // One candidate per known SSID in range, through its strongest AP
+  for (wifi_ssid_count_t i = 0; i < n; i++)
+  {
+    bssid = NULL;
+
+#if defined(ESP8266)
+    WiFi.getNetworkInfo(i, ssid, encryptionType, RSSI, bssid, channel, isHidden);
+#else
+    WiFi.getNetworkInfo(i, ssid, encryptionType, RSSI, bssid, channel);
+#endif
+
+    int index = find(ssid.c_str());
+
+    if ( (index < 0) || !bssid )
+      continue;
+
+    uint8_t j = 0;
+
+    while ( (j < count) && (candidates[j].index != index) )
+      j++;
+
+    if ( (j < count) && (candidates[j].RSSI >= RSSI) )
+      continue;
+
+    if (j == count)
+      count++;
+
+    candidates[j].index   = index;
+    candidates[j].RSSI    = RSSI;
+    candidates[j].channel = channel;
+
+    memcpy(candidates[j].bssid, bssid, sizeof(candidates[j].bssid));
+  }
+
+  WiFi.scanDelete();
+
+  LOGWARN3(F("Known networks in range ="), count, F(", APs ="), n);
+
+  if (count == 0)
+    return WL_NO_SSID_AVAIL;
+
+  std::sort(candidates, candidates + count, [this](const Candidate & a, const Candidate & b)
+  {
+    const WM_KnownNetwork& na = _record.networks[a.index];
+    const WM_KnownNetwork& nb = _record.networks[b.index];
+
+    if (isBetter(na, nb) || isBetter(nb, na))
+      return isBetter(na, nb);
+
+    return (a.RSSI > b.RSSI);
+  });
+
+  wl_status_t status = WL_NO_SSID_AVAIL;
+
+  for (uint8_t i = 0; i < count; i++)
+  {
+    WM_KnownNetwork& network = _record.networks[candidates[i].index];
+
+    LOGWARN3(F("Connect to known"), network.ssid, F(", RSSI ="), candidates[i].RSSI);
+
+    WiFi.begin(network.ssid, network.pass, candidates[i].channel, candidates[i].bssid);
+
+    ESPAsync_WMConnectWaiter connectWaiter;
+
+    connectWaiter.begin(timeout);
+
+    status = connectWaiter.wait(idle);
+
+    if (status == WL_CONNECTED)
+    {
+      connected();
+
+      return status;
+    }
+
+    if (network.failures < 0xFF)
+      network.failures++;
+
+    _dirty = true;
+
+    WiFi.disconnect();
+  }
+
+  return status;
+}
+
+#endif    // USE_WM_KNOWN_NETWORKS
+
+//////////////////////////////////////////
+
+#if USE_WM_TIMELINE
+
+ESPAsync_WMTimeline ESPAsync_WMtimeline;
+
+//////////////////////////////////////////
+
+uint32_t ESPAsync_WMTimeline::begin(const __FlashStringHelper* name)
+{
+  Span& span = _spans[_nextID % WM_TIMELINE_SIZE];
+
+  span.name     = name;
+  span.id       = _nextID;
+  span.depth    = _depth++;
+  span.duration = WM_SPAN_OPEN;
+  span.start    = micros();
+
+  return _nextID++;
+}
+
+//////////////////////////////////////////
+
+void ESPAsync_WMTimeline::end(const uint32_t& id)
+{
+  uint32_t now = micros();
+
+  if (_depth > 0)
+    _depth--;
+
+  Span& span = _spans[id % WM_TIMELINE_SIZE];
+
+  if ( (span.id == id) && (span.duration == WM_SPAN_OPEN) )
+  {
+    span.duration = now - span.start;
+  }
+}
+
+//////////////////////////////////////////
+
+void ESPAsync_WMTimeline::clear()
+{
+  _nextID = 0;
+  _depth  = 0;
+}
+
+//////////////////////////////////////////
+
+uint8_t ESPAsync_WMTimeline::count()
+{
+  return (_nextID < WM_TIMELINE_SIZE) ? _nextID : WM_TIMELINE_SIZE;
+}
+
+//////////////////////////////////////////
+
+const ESPAsync_WMTimeline::Span* ESPAsync_WMTimeline::span(const uint8_t& index)
+{
+  if (index >= count())
+    return NULL;
+
+  return &_spans[(_nextID - count() + index) % WM_TIMELINE_SIZE];
+}
+
+//////////////////////////////////////////
+
+void ESPAsync_WMTimeline::print(Print& out)
+{
+  out.println(F("Timeline (start ms, duration ms) :"));
+
+  for (uint8_t i = 0; i < count(); i++)
+  {
+    const Span *s = span(i);
+
+    out.print(s->start / 1000.0f, 3);
+    out.print('\t');
+
+    if (s->duration == WM_SPAN_OPEN)
+      out.print(F("open"));
+    else
+      out.print(s->duration / 1000.0f, 3);
+
+    out.print('\t');
+
+    for (uint8_t d = 0; d < s->depth; d++)
+      out.print(F("  "));
+
+    out.println(s->name);
+  }
+}
+
+//////////////////////////////////////////
+
+// [{"name":"...","start":us,"duration":us,"depth":n},...], duration null for the spans not ended yet
+void ESPAsync_WMTimeline::toJSON(String& out)
+{
+  out.reserve(out.length() + count() * 72);
+
+  out += '[';
+
+  for (uint8_t i = 0; i < count(); i++)
+  {
+    const Span *s = span(i);
+
+    if (i > 0)
+      out += ',';
+
+    out += F("{\"name\":\"");
+    out += s->name;
+    out += F("\",\"start\":");
+    out += s->start;
+    out += F(",\"duration\":");
+
+    if (s->duration == WM_SPAN_OPEN)
+      out += F("null");
+    else
+      out += s->duration;
+
+    out += F(",\"depth\":");
+    out += s->depth;
+    out += '}';
+  }
+
+  out += ']';
+}
+
+#endif    // USE_WM_TIMELINE
+
+//////////////////////////////////////////
+
+#if USE_WM_METRICS
+
+ESPAsync_WMMetrics ESPAsync_WMmetrics;
+
+// Handler time of the portal routes, in us
+static const uint32_t WM_REQUEST_BUCKETS_US[] = { 1000, 5000, 10000, 50000, 100000, 500000 };
+
+// Scans and connections, in ms
+static const uint32_t WM_SCAN_BUCKETS_MS[]    = { 500, 1000, 2000, 3000, 5000, 10000 };
+static const uint32_t WM_CONNECT_BUCKETS_MS[] = { 250, 500, 1000, 2000, 3000, 5000, 10000, 20000 };
+
+static const char* const WM_METRICS_ROUTE_NAMES[WM_ROUTE_COUNT] =
+{
+  "/", "/wifi", "/wifisave", "/close", "/i", "/r", "/state", "/scan", "asset", "/timeline", "/metrics", "/log", "probe", "not_found"
+};
+
+//////////////////////////////////////////
+
+ESPAsync_WMHistogram::ESPAsync_WMHistogram()
+{
+  for (uint8_t i = 0; i <= WM_HISTOGRAM_MAX_BUCKETS; i++)
+    _buckets[i] = 0;
+
+  _count  = 0;
+  _sum    = 0;
+}
+
+//////////////////////////////////////////
+
+void ESPAsync_WMHistogram::setBuckets(const uint32_t* bounds, const uint8_t& count, const uint32_t& scale)
+{
+  _bounds     = bounds;
+  _numBounds  = std::min(count, (uint8_t) WM_HISTOGRAM_MAX_BUCKETS);
+  _scale      = scale;
+}
+
+//////////////////////////////////////////
+
+void ESPAsync_WMHistogram::observe(const uint32_t& value)
+{
+  uint8_t i = 0;
+
+  while ( (i < _numBounds) && (value > _bounds[i]) )
+    i++;
+
+  // Not cumulative here, summed up by write()
+  _buckets[i] += 1;
+  _count      += 1;
+  _sum        += value;
+}
+
+//////////////////////////////////////////
+
+void ESPAsync_WMHistogram::write(Print& out, const __FlashStringHelper* name, const char* labelName,
+                                 const char* labelValue)
+{
+  uint32_t cumulative = 0;
+
+  for (uint8_t i = 0; i <= _numBounds; i++)
+  {
+    cumulative += _buckets[i];
+
+    out.print(name);
+    out.print(F("_bucket{"));
+
+    if (labelName)
+    {
+      out.print(labelName);
+      out.print(F("=\""));
+      out.print(labelValue);
+      out.print(F("\","));
+    }
+
+    out.print(F("le=\""));
+
+    if (i < _numBounds)
+      out.print((float) _bounds[i] / _scale, 3);
+    else
+      out.print(F("+Inf"));
+
+    out.print(F("\"} "));
+    out.println(cumulative);
+  }
+
+  for (uint8_t i = 0; i < 2; i++)
+  {
+    out.print(name);
+    out.print(i == 0 ? F("_sum") : F("_count"));
+
+    if (labelName)
+    {
+      out.print('{');
+      out.print(labelName);
+      out.print(F("=\""));
+      out.print(labelValue);
+      out.print(F("\"}"));
+    }
+
+    out.print(' ');
+
+    if (i == 0)
+      out.println((float) _sum / _scale, 3);
+    else
+      out.println((uint32_t) _count);
+  }
+}
+
+//////////////////////////////////////////
+
+ESPAsync_WMMetrics::ESPAsync_WMMetrics()
+{
+  for (uint8_t i = 0; i < WM_ROUTE_COUNT; i++)
+  {
+    _requestTime[i].setBuckets(WM_REQUEST_BUCKETS_US, sizeof(WM_REQUEST_BUCKETS_US) / sizeof(uint32_t), 1000000UL);
+    _requestBytes[i] = 0;
+  }
+
+  _scanTime.setBuckets(WM_SCAN_BUCKETS_MS, sizeof(WM_SCAN_BUCKETS_MS) / sizeof(uint32_t), 1000UL);
+  _connectTime.setBuckets(WM_CONNECT_BUCKETS_MS, sizeof(WM_CONNECT_BUCKETS_MS) / sizeof(uint32_t), 1000UL);
+
+  for (uint8_t i = 0; i < WM_METRICS_STATUS_COUNT; i++)
+    _connectResults[i] = 0;
+
+  _scanNetworks = 0;
+  _reconnects   = 0;
+}
+
+//////////////////////////////////////////
+
+void ESPAsync_WMMetrics::request(const uint8_t& route, const uint32_t& us)
+{
+  if (route < WM_ROUTE_COUNT)
+    _requestTime[route].observe(us);
+}
+
+//////////////////////////////////////////
+
+void ESPAsync_WMMetrics::responseBytes(const uint8_t& route, const size_t& bytes)
+{
+  if (route < WM_ROUTE_COUNT)
+    _requestBytes[route] += bytes;
+}
+
+//////////////////////////////////////////
+
+void ESPAsync_WMMetrics::scan(const uint32_t& ms, const int& networks)
+{
+  _scanTime.observe(ms);
+  _scanNetworks = (networks > 0) ? networks : 0;
+}
+
+//////////////////////////////////////////
+
+void ESPAsync_WMMetrics::connect(const wl_status_t& status, const uint32_t& ms)
+{
+  if ( (uint8_t) status < WM_METRICS_STATUS_COUNT )
+    _connectResults[status] += 1;
+
+  if (status == WL_CONNECTED)
+    _connectTime.observe(ms);
+}
+
+//////////////////////////////////////////
+
+void ESPAsync_WMMetrics::reconnect()
+{
+  _reconnects += 1;
+}
+
+//////////////////////////////////////////
+
+void ESPAsync_WMMetrics::write(Print& out)
+{
+  out.println(F("# TYPE wm_http_request_duration_seconds histogram"));
+
+  // Routes never requested are left out, to keep the page short
+  for (uint8_t i = 0; i < WM_ROUTE_COUNT; i++)
+  {
+    if (_requestTime[i].count())
+      _requestTime[i].write(out, F("wm_http_request_duration_seconds"), "route", WM_METRICS_ROUTE_NAMES[i]);
+  }
+
+  out.println(F("# TYPE wm_http_response_bytes_total counter"));
+
+  for (uint8_t i = 0; i < WM_ROUTE_COUNT; i++)
+  {
+    if (_requestTime[i].count())
+    {
+      out.print(F("wm_http_response_bytes_total{route=\""));
+      out.print(WM_METRICS_ROUTE_NAMES[i]);
+      out.print(F("\"} "));
+      out.println((uint32_t) _requestBytes[i]);
+    }
+  }
+
+  out.println(F("# TYPE wm_wifi_scan_duration_seconds histogram"));
+  _scanTime.write(out, F("wm_wifi_scan_duration_seconds"));
+
+  out.println(F("# TYPE wm_wifi_scan_networks gauge"));
+  out.print(F("wm_wifi_scan_networks "));
+  out.println((uint32_t) _scanNetworks);
+
+  // By wl_status_t value, 3 = WL_CONNECTED
+  out.println(F("# TYPE wm_wifi_connect_attempts_total counter"));
+
+  for (uint8_t i = 0; i < WM_METRICS_STATUS_COUNT; i++)
+  {
+    if (_connectResults[i])
+    {
+      out.print(F("wm_wifi_connect_attempts_total{status=\""));
+      out.print(i);
+      out.print(F("\"} "));
+      out.println((uint32_t) _connectResults[i]);
+    }
+  }
+
+  out.println(F("# TYPE wm_wifi_connect_duration_seconds histogram"));
+  _connectTime.write(out, F("wm_wifi_connect_duration_seconds"));
+
+  out.println(F("# TYPE wm_wifi_reconnects_total counter"));
+  out.print(F("wm_wifi_reconnects_total "));
+  out.println((uint32_t) _reconnects);
+
+  out.println(F("# TYPE wm_heap_free_bytes gauge"));
+  out.print(F("wm_heap_free_bytes "));
+  out.println(ESP.getFreeHeap());
+
+  out.println(F("# TYPE wm_heap_max_block_bytes gauge"));
+  out.print(F("wm_heap_max_block_bytes "));
+
+#ifdef ESP8266
+  out.println(ESP.getMaxFreeBlockSize());
+#else
+  out.println(ESP.getMaxAllocHeap());
+#endif
+}
+
+#endif    // USE_WM_METRICS
+
+//////////////////////////////////////////
+
+#if USE_WM_ADMISSION
+
+// Estimated heap used by each route's response while it's sent, indexed like WM_METRICS_ROUTE_NAMES.
+// 0 : always admitted. Assets and probes are sent from flash, and a refused action (/wifisave, /close, /r)
+// would be lost, the busy page reloads with GET
+static const uint16_t WM_ADMISSION_COST[WM_ROUTE_COUNT] =
+{
+  1536, 3072, 0, 0, 4096, 0, 512, 1024, 0, 1536, 3072, 2560, 0, 512
+};
+
+//////////////////////////////////////////
+
+size_t ESPAsync_WMAdmission::largestFreeBlock()
+{
+#ifdef ESP8266
+  return ESP.getMaxFreeBlockSize();
+#else
+  // heap_caps_get_largest_free_block() of the internal 8-bit capable heap
+  return ESP.getMaxAllocHeap();
+#endif
+}
+
+//////////////////////////////////////////
+
+bool ESPAsync_WMAdmission::admit(const uint32_t& cost)
+{
+  // Always let one response through, unless the heap is really too low for it
+  if ( (_inFlight > 0) && (_inFlightBytes + cost > WM_ADMISSION_BUDGET) )
+  {
+    _rejectedBudget++;
+
+    return false;
+  }
+
+  if (largestFreeBlock() < cost + WM_ADMISSION_HEAP_RESERVE)
+  {
+    _rejectedHeap++;
+
+    return false;
+  }
+
+  _inFlight++;
+  _inFlightBytes += cost;
+  _admitted++;
+
+  return true;
+}
+
+//////////////////////////////////////////
+
+void ESPAsync_WMAdmission::release(const uint32_t& cost)
+{
+  if (_inFlight > 0)
+  {
+    _inFlight--;
+    _inFlightBytes -= std::min(cost, _inFlightBytes);
+  }
+}
+
+//////////////////////////////////////////
+
+void ESPAsync_WMAdmission::write(Print& out)
+{
+  out.println(F("# TYPE wm_http_inflight_requests gauge"));
+  out.print(F("wm_http_inflight_requests "));
+  out.println(_inFlight);
+
+  out.println(F("# TYPE wm_http_inflight_bytes gauge"));
+  out.print(F("wm_http_inflight_bytes "));
+  out.println(_inFlightBytes);
+
+  out.println(F("# TYPE wm_http_admitted_total counter"));
+  out.print(F("wm_http_admitted_total "));
+  out.println(_admitted);
+
+  out.println(F("# TYPE wm_http_rejected_total counter"));
+  out.print(F("wm_http_rejected_total{reason=\"budget\"} "));
+  out.println(_rejectedBudget);
+  out.print(F("wm_http_rejected_total{reason=\"heap\"} "));
+  out.println(_rejectedHeap);
+}
+
+#endif    // USE_WM_ADMISSION
+
+//////////////////////////////////////////
+
+/**
+   [getParameters description]
+   @access public
+*/
+ESPAsync_WMParameter** ESPAsync_WiFiManager::getParameters()
+{
+  return _params;
+}
+
+//////////////////////////////////////////
+//////////////////////////////////////////
+
+/**
+   [getParametersCount description]
+   @access public
+*/
+int ESPAsync_WiFiManager::getParametersCount()
+{
+  return _paramsCount;
+}
+
+//////////////////////////////////////////
+
+char* ESPAsync_WiFiManager::getRFC952_hostname(const char* iHostname)
+{
+  memset(RFC952_hostname, 0, sizeof(RFC952_hostname));
+
+  size_t len = (RFC952_HOSTNAME_MAXLEN < strlen(iHostname)) ? RFC952_HOSTNAME_MAXLEN : strlen(iHostname);
+
+  size_t j = 0;
+
+  for (size_t i = 0; i < len - 1; i++)
+  {
+    if (isalnum(iHostname[i]) || iHostname[i] == '-')
+    {
+      RFC952_hostname[j] = iHostname[i];
+      j++;
+    }
+  }
+
+  // no '-' as last char
+  if (isalnum(iHostname[len - 1]) || (iHostname[len - 1] != '-'))
+    RFC952_hostname[j] = iHostname[len - 1];
+
+  return RFC952_hostname;
+}
+
+//////////////////////////////////////////
+
+ESPAsync_WiFiManager::ESPAsync_WiFiManager(AsyncWebServer * webserver, AsyncDNSServer *dnsserver, const char *iHostname)
+{
+
+  server    = webserver;
+  dnsServer = dnsserver;
+
+  _modeless     = false;
+  shouldscan    = true;
+
+#if USE_DYNAMIC_PARAMS
+  _max_params = WIFI_MANAGER_MAX_PARAMS;
+  _params = (ESPAsync_WMParameter**)malloc(_max_params * sizeof(ESPAsync_WMParameter*));
+#endif
+
+  //WiFi not yet started here, must call WiFi.mode(WIFI_STA) and modify function WiFiGenericClass::mode(wifi_mode_t m) !!!
+  WiFi.mode(WIFI_STA);
+
+  if (iHostname[0] == 0)
+  {
+#ifdef ESP8266
+    String _hostname = "ESP8266-" + String(ESP.getChipId(), HEX);
+#else    //ESP32
+    String _hostname = "ESP32-" + String(ESP_getChipId(), HEX);
+#endif
+
+    _hostname.toUpperCase();
+
+    getRFC952_hostname(_hostname.c_str());
+
+  }
+  else
+  {
+    // Prepare and store the hostname only not NULL
+    getRFC952_hostname(iHostname);
+  }
+
+  LOGWARN1(F("RFC925 Hostname ="), RFC952_hostname);
+
+  setHostname();
+
+  networkIndices = NULL;
+}
+
+//////////////////////////////////////////
+
+ESPAsync_WiFiManager::~ESPAsync_WiFiManager()
+{
+#if USE_DYNAMIC_PARAMS
+
+  if ( (_params != NULL) && !_paramsInArena )
+  {
+    LOGINFO(F("freeing allocated params!"));
+
+    free(_params);
+  }
+
+#endif
+
+  if (networkIndices)
+  {
+    free(networkIndices); //indices array no longer required so free memory
+  }
+
+  if (_scanCache)
+    delete _scanCache;
+
+#if USE_WM_RENDER_CACHE
+  // The WiFi event handlers point to this
+  unsubscribeRendered();
+#endif
+}
+
+//////////////////////////////////////////
+
+#if USE_DYNAMIC_PARAMS
+  bool ESPAsync_WiFiManager::addParameter(ESPAsync_WMParameter *p)
+#else
+  void ESPAsync_WiFiManager::addParameter(ESPAsync_WMParameter *p)
+#endif
+{
+#if USE_DYNAMIC_PARAMS
+
+  if (_paramsCount == _max_params)
+  {
+    // rezise the params array
+    _max_params += WIFI_MANAGER_MAX_PARAMS;
+
+    LOGINFO1(F("Increasing _max_params to:"), _max_params);
+
+    ESPAsync_WMParameter** new_params;
+
+    if (_paramsInArena)
+    {
+      // Arena table full, move out of it
+      new_params = (ESPAsync_WMParameter**) malloc(_max_params * sizeof(ESPAsync_WMParameter*));
+
+      if (new_params != NULL)
+      {
+        memcpy(new_params, _params, _paramsCount * sizeof(ESPAsync_WMParameter*));
+        _paramsInArena = false;
+      }
+    }
+    else
+    {
+      new_params = (ESPAsync_WMParameter**)realloc(_params, _max_params * sizeof(ESPAsync_WMParameter*));
+    }
+
+    if (new_params != NULL)
+    {
+      _params = new_params;
+    }
+    else
+    {
+      LOGINFO(F("ERROR: failed to realloc params, size not increased!"));
+
+      return false;
+    }
+  }
+
+  _params[_paramsCount] = p;
+  _paramsCount++;
+
+  _formFieldsValid = false;
+
+  LOGINFO1(F("Adding parameter"), p->getID());
+
+  return true;
+
+#else
+
+  // Danger here. Better to use Tzapu way here
+  if (_paramsCount < (WIFI_MANAGER_MAX_PARAMS))
+  {
+    _params[_paramsCount] = p;
+    _paramsCount++;
+
+    _formFieldsValid = false;
+
+    LOGINFO1(F("Adding parameter"), p->getID());
+  }
+  else
+  {
+    LOGINFO("Can't add parameter. Full");
+  }
+
+#endif
+}
+
+//////////////////////////////////////////
+
+#if USE_DYNAMIC_PARAMS
+
+void ESPAsync_WiFiManager::setParamArena(ESPAsync_WMParamArena* arena)
+{
+  if ( (arena == NULL) || (arena->maxParams() < _paramsCount) || (arena->maxParams() == 0) )
+  {
+    LOGERROR(F("setParamArena: Arena table too small"));
+
+    return;
+  }
+
+  ESPAsync_WMParameter** new_params = arena->table();
+
+  memcpy(new_params, _params, _paramsCount * sizeof(ESPAsync_WMParameter*));
+
+  if (!_paramsInArena)
+    free(_params);
+
+  _params         = new_params;
+  _max_params     = arena->maxParams();
+  _paramsInArena  = true;
+
+  LOGINFO3(F("ParamArena size ="), arena->size(), F(", used ="), arena->used());
+}
+
+#endif
+
+//////////////////////////////////////////
+
+void ESPAsync_WiFiManager::setupConfigPortal()
+{
+  WM_SPAN("setupConfigPortal");
+
+  stopConfigPortal = false; //Signal not to close config portal
+
+  /*This library assumes autoconnect is set to 1. It usually is
+    but just in case check the setting and turn on autoconnect if it is off.
+    Some useful discussion at https://github.com/esp8266/Arduino/issues/1615*/
+  if (WiFi.getAutoConnect() == 0)
+    WiFi.setAutoConnect(1);
+
+#if !( USING_ESP32_S2 || USING_ESP32_C3 )
+#ifdef ESP8266
+  // KH, mod for Async
+  server->reset();
+#else   //ESP32
+  server->reset();
+#endif
+
+#if USE_WM_EVENTS
+  // Deleted with the other handlers
+  _events = NULL;
+#endif
+
+#if !USE_WM_CAPTIVE_DNS
+  if (!dnsServer)
+    dnsServer = new AsyncDNSServer;
+#endif
+
+#endif    // ( USING_ESP32_S2 || USING_ESP32_C3 )
+
+  // optional soft ip config
+  // Must be put here before dns server start to take care of the non-default ConfigPortal AP IP.
+  // Check (https://github.com/khoih-prog/ESP_WiFiManager/issues/58)
+  if (_WiFi_AP_IPconfig._ap_static_ip)
+  {
+    LOGWARN3(F("Custom AP IP/GW/Subnet = "), _WiFi_AP_IPconfig._ap_static_ip, _WiFi_AP_IPconfig._ap_static_gw,
+             _WiFi_AP_IPconfig._ap_static_sn);
+
+    WiFi.softAPConfig(_WiFi_AP_IPconfig._ap_static_ip, _WiFi_AP_IPconfig._ap_static_gw, _WiFi_AP_IPconfig._ap_static_sn);
+  }
+
+  /* Setup the DNS server redirecting all the domains to the apIP */
+#if USE_WM_CAPTIVE_DNS
+  WM_SPAN_BEGIN(dnsSpan, "DNS start");
+
+  if (!_captiveDNS.start(WiFi.softAPIP(), DNS_PORT))
+  {
+    LOGERROR(F("Can't start captive DNS. No available socket"));
+  }
+
+  WM_SPAN_END(dnsSpan);
+#else
+  if (dnsServer)
+  {
+    WM_SPAN_BEGIN(dnsSpan, "DNS start");
+
+    dnsServer->setErrorReplyCode(AsyncDNSReplyCode::NoError);
+
+    // AsyncDNSServer started with "*" domain name, all DNS requests will be passsed to WiFi.softAPIP()
+    if (! dnsServer->start(DNS_PORT, "*", WiFi.softAPIP()))
+    {
+      // No socket available
+      LOGERROR(F("Can't start DNS Server. No available socket"));
+    }
+
+    WM_SPAN_END(dnsSpan);
+  }
+#endif    // USE_WM_CAPTIVE_DNS
+
+  _configPortalStart = millis();
+
+  LOGWARN1(F("\nConfiguring AP SSID ="), _apName);
+
+  if (_apPassword != NULL)
+  {
+    if (strlen(_apPassword) < 8 || strlen(_apPassword) > 63)
+    {
+      // fail passphrase to short or long!
+      LOGERROR(F("Invalid AccessPoint password. Ignoring"));
+
+      _apPassword = NULL;
+    }
+
+    // Only the length, the log may be served on /log
+    LOGWARN1(F("AP PWD length ="), _apPassword ? strlen(_apPassword) : 0);
+  }
+
+  // KH, To enable dynamic/random channel
+  static int channel;
+
+  // Use random channel if  _WiFiAPChannel == 0
+  if (_WiFiAPChannel == 0)
+    channel = (_configPortalStart % MAX_WIFI_CHANNEL) + 1;
+  else
+    channel = _WiFiAPChannel;
+
+  LOGWARN1(F("AP Channel ="), channel);
+
+  WM_SPAN_BEGIN(softAPSpan, "softAP");
+
+  WiFi.softAP(_apName, _apPassword, channel);
+
+  delay(500); // Without delay I've seen the IP address blank
+
+  WM_SPAN_END(softAPSpan);
+
+  LOGWARN1(F("AP IP address ="), WiFi.softAPIP());
+
+  IPAddress portalIP = WiFi.softAPIP();
+
+  snprintf(_portalLocation, sizeof(_portalLocation), "http://%u.%u.%u.%u/", portalIP[0], portalIP[1], portalIP[2], portalIP[3]);
+
+#if USE_WM_RENDER_CACHE
+  // New AP name and IP, nothing rendered before is valid anymore
+  subscribeRendered();
+  invalidateRendered();
+#endif
+
+  /* Setup web pages: root, wifi config pages, SO captive portal detectors and not found. */
+
+  server->on("/",         measured(WM_ROUTE_ROOT,       &ESPAsync_WiFiManager::handleRoot)).setFilter(ON_AP_FILTER);
+  server->on("/wifi",     measured(WM_ROUTE_WIFI,       &ESPAsync_WiFiManager::handleWifi)).setFilter(ON_AP_FILTER);
+  server->on("/wifisave", measured(WM_ROUTE_WIFISAVE,   &ESPAsync_WiFiManager::handleWifiSave)).setFilter(ON_AP_FILTER);
+  server->on("/close",    measured(WM_ROUTE_CLOSE,      &ESPAsync_WiFiManager::handleServerClose)).setFilter(ON_AP_FILTER);
+  server->on("/i",        measured(WM_ROUTE_INFO,       &ESPAsync_WiFiManager::handleInfo)).setFilter(ON_AP_FILTER);
+  server->on("/r",        measured(WM_ROUTE_RESET,      &ESPAsync_WiFiManager::handleReset)).setFilter(ON_AP_FILTER);
+  server->on("/state",    measured(WM_ROUTE_STATE,      &ESPAsync_WiFiManager::handleState)).setFilter(ON_AP_FILTER);
+  server->on("/scan",     measured(WM_ROUTE_SCAN,       &ESPAsync_WiFiManager::handleScan)).setFilter(ON_AP_FILTER);
+
+#if USE_WM_TIMELINE
+  server->on("/timeline", measured(WM_ROUTE_TIMELINE,   &ESPAsync_WiFiManager::handleTimeline)).setFilter(ON_AP_FILTER);
+#endif
+
+#if USE_WM_METRICS
+  // No ON_AP_FILTER, to be scraped over the station interface too while a modeless portal runs
+  server->on("/metrics",  measured(WM_ROUTE_METRICS,    &ESPAsync_WiFiManager::handleMetrics));
+#endif
+
+#if ( USE_WM_DEFERRED_LOG && USE_WM_LOG_ROUTE )
+  server->on("/log",      measured(WM_ROUTE_LOG,        &ESPAsync_WiFiManager::handleLog)).setFilter(ON_AP_FILTER);
+#endif
+
+#if USE_WM_EVENTS
+  // Not measured, the connections stay open
+  if (!_events)
+  {
+    _events = new AsyncEventSource("/events");
+
+    // Runs in the async TCP task : only ask the loop to send the current status again
+    _events->onConnect([this](AsyncEventSourceClient * client)
+    {
+      (void) client;
+
+      _eventStatus = -1;
+    });
+
+    _events->setFilter(ON_AP_FILTER);
+    server->addHandler(_events);
+  }
+#endif
+
+#if USE_WM_GZIP_ASSETS
+  server->on("/wm.css", HTTP_GET, measured(WM_ROUTE_ASSET, [this](AsyncWebServerRequest * request)
+  {
+    handleAsset(request, WM_ASSET_CSS_GZ, sizeof(WM_ASSET_CSS_GZ), WM_HTTP_CT_CSS, WM_ASSET_CSS_ETAG);
+  })).setFilter(ON_AP_FILTER);
+
+  server->on("/wm.js", HTTP_GET, measured(WM_ROUTE_ASSET, [this](AsyncWebServerRequest * request)
+  {
+    handleAsset(request, WM_ASSET_JS_GZ, sizeof(WM_ASSET_JS_GZ), WM_HTTP_CT_JS, WM_ASSET_JS_ETAG);
+  })).setFilter(ON_AP_FILTER);
+
+  server->on("/tz.js", HTTP_GET, measured(WM_ROUTE_ASSET, [this](AsyncWebServerRequest * request)
+  {
+    handleAsset(request, WM_ASSET_TZ_GZ, sizeof(WM_ASSET_TZ_GZ), WM_HTTP_CT_JS, WM_ASSET_TZ_ETAG);
+  })).setFilter(ON_AP_FILTER);
+#endif
+
+  // Answered without looking at the host nor formatting anything, they come in bursts when a device joins
+  for (const char* probe : WM_CAPTIVE_PROBES)
+  {
+    server->on(probe, HTTP_GET, measured(WM_ROUTE_PROBE, &ESPAsync_WiFiManager::handleProbe)).setFilter(ON_AP_FILTER);
+  }
+
+  //Microsoft captive portal. Maybe not needed. Might be handled by notFound handler.
+  server->on("/fwlink",   measured(WM_ROUTE_ROOT,       &ESPAsync_WiFiManager::handleRoot)).setFilter(ON_AP_FILTER);
+  server->onNotFound (measured(WM_ROUTE_NOT_FOUND,      &ESPAsync_WiFiManager::handleNotFound));
+
+  server->begin(); // Web server start
+
+  LOGWARN(F("HTTP server started"));
+}
+
+//////////////////////////////////////////
+
+bool ESPAsync_WiFiManager::autoConnect()
+{
+#ifdef ESP8266
   String ssid = "ESP_" + String(ESP.getChipId());
 #else   //ESP32
   String ssid = "ESP_" + String(ESP_getChipId());
@@ -522,46 +2291,59 @@ String ESPAsync_WiFiManager::networkListAsString()
 {
   String pager ;
 
+  WiFiScanSnapshotPtr snapshot = getScanSnapshot();
+
+  if (!snapshot)
+    return pager;
+
+  String item;
+
   //display networks in page
-  for (int i = 0; i < wifiSSIDCount; i++)
+  for (int i = 0; i < snapshot->count; i++)
   {
-    if (wifiSSIDs[i].duplicate == true)
-      continue; // skip dups
+    item = "";
+
+    if (networkItemAsString(item, snapshot->results[i], _minimumQuality))
+      pager += item;
+  }
 
-    int quality = getRSSIasQuality(wifiSSIDs[i].RSSI);
+  return pager;
+}
 
-    if (_minimumQuality == -1 || _minimumQuality < quality)
-    {
-      String item = FPSTR(WM_HTTP_ITEM);
-      String rssiQ;
+//////////////////////////////////////////
 
-      rssiQ += quality;
-      item.replace("{v}", wifiSSIDs[i].SSID);
-      item.replace("{r}", rssiQ);
+// Returns false, leaving item untouched, if the AP is a duplicate or below _minimumQuality
+ESPAsync_WMTemplate ESPAsync_WiFiManager::_networkItemTemplate { WM_HTTP_ITEM, "v,r,i" };
 
-#if defined(ESP8266)
+bool ESPAsync_WiFiManager::networkItemAsString(String& item, const WiFiResult& result, const int& minimumQuality)
+{
+  if (result.duplicate == true)
+    return false; // skip dups
+
+  int quality = getRSSIasQuality(result.RSSI);
 
-      if (wifiSSIDs[i].encryptionType != ENC_TYPE_NONE)
+  if (minimumQuality == -1 || minimumQuality < quality)
+  {
+    char rssiQ[8];
+
+    snprintf(rssiQ, sizeof(rssiQ), "%d", quality);
+
+#if defined(ESP8266)
+    bool encrypted = (result.encryptionType != ENC_TYPE_NONE);
 #else
-      if (wifiSSIDs[i].encryptionType != WIFI_AUTH_OPEN)
+    bool encrypted = (result.encryptionType != WIFI_AUTH_OPEN);
 #endif
-      {
-        item.replace("{i}", "l");
-      }
-      else
-      {
-        item.replace("{i}", "");
-      }
 
-      pager += item;
-    }
-    else
-    {
-      LOGDEBUG(F("Skipping due to quality"));
-    }
+    const char* values[] = { result.SSID.c_str(), rssiQ, encrypted ? "l" : "" };
+
+    _networkItemTemplate.render(item, values);
+
+    return true;
   }
 
-  return pager;
+  LOGDEBUG(F("Skipping due to quality"));
+
+  return false;
 }
 
 //////////////////////////////////////////
@@ -583,104 +2365,399 @@ void ESPAsync_WiFiManager::scan()
   if (!shouldscan)
     return;
 
+  // Finish the pending async scan instead of starting a new one on top of it
+  if (_asyncScanRunning)
+  {
+    LOGDEBUG(F("Wait for async scan"));
+
+    while ( (WiFi.scanComplete() == WIFI_SCAN_RUNNING) && (millis() - _asyncScanStart < TIME_MAX_ASYNC_SCAN) )
+    {
+      delay(10);
+    }
+
+    pollAsyncScan();
+
+    return;
+  }
+
   LOGDEBUG(F("About to scan"));
 
-  if (wifiSSIDscan)
+#if USE_WM_METRICS
+  unsigned long scanStart = millis();
+#endif
+
+  wifi_ssid_count_t n = WiFi.scanNetworks(false, true);
+
+  LOGDEBUG(F("Scan done"));
+
+#if USE_WM_METRICS
+  ESPAsync_WMmetrics.scan(millis() - scanStart, n);
+#endif
+
+  processScanResults(n);
+}
+
+//////////////////////////////////////////
+
+// Kick off a background scan. Returns immediately, results are picked up by pollAsyncScan()
+void ESPAsync_WiFiManager::startAsyncScan()
+{
+  if (!shouldscan || _asyncScanRunning)
+    return;
+
+  LOGDEBUG(F("Start async scan"));
+
+  wifi_ssid_count_t n = WiFi.scanNetworks(true, true);
+
+  if (n == WIFI_SCAN_FAILED)
   {
-    delay(100);
+    LOGDEBUG(F("WIFI_SCAN_FAILED!"));
+
+    return;
   }
 
-  if (wifiSSIDscan)
+  _asyncScanRunning = true;
+  _asyncScanStart   = millis();
+}
+
+//////////////////////////////////////////
+
+// Non-blocking. Publish the new results once the background scan is done.
+// Until then, the previous results are served.
+void ESPAsync_WiFiManager::pollAsyncScan()
+{
+  if (!_asyncScanRunning)
+    return;
+
+  wifi_ssid_count_t n = WiFi.scanComplete();
+
+  if (n == WIFI_SCAN_RUNNING)
   {
-    LOGDEBUG(F("Start scan"));
+    if (millis() - _asyncScanStart > TIME_MAX_ASYNC_SCAN)
+    {
+      LOGDEBUG(F("Async scan timed out"));
+
+      WiFi.scanDelete();
+      _asyncScanRunning = false;
+    }
+
+    return;
+  }
 
-    wifi_ssid_count_t n = WiFi.scanNetworks(false, true);
+  _asyncScanRunning = false;
 
-    LOGDEBUG(F("Scan done"));
+  LOGDEBUG(F("Async scan done"));
 
-    if (n == WIFI_SCAN_FAILED)
+#if USE_WM_METRICS
+  ESPAsync_WMmetrics.scan(millis() - _asyncScanStart, n);
+#endif
+
+  processScanResults(n);
+}
+
+//////////////////////////////////////////
+
+void ESPAsync_WiFiManager::processScanResults(const wifi_ssid_count_t& n)
+{
+  if (n == WIFI_SCAN_FAILED)
+  {
+    LOGDEBUG(F("WIFI_SCAN_FAILED!"));
+  }
+  else if (n == WIFI_SCAN_RUNNING)
+  {
+    LOGDEBUG(F("WIFI_SCAN_RUNNING!"));
+  }
+  else if (n < 0)
+  {
+    LOGDEBUG(F("Failed, unknown error code!"));
+  }
+  else
+  {
+    if (n == 0)
     {
-      LOGDEBUG(F("WIFI_SCAN_FAILED!"));
+      LOGDEBUG(F("No network found"));
     }
-    else if (n == WIFI_SCAN_RUNNING)
+
+    // Even with no network found, to age out the cached ones
+    mergeScanResults(n);
+
+    if (!_scanCache)
+      return;
+
+    wifi_ssid_count_t count = _scanCache->count;
+
+    // Build the new list completely, off to the side, before publishing it.
+    // Recycle the spare snapshot if no handler holds it anymore, to avoid reallocating
+    // (and fragmenting the heap) on every scan.
+    WiFiScanSnapshotPtr snapshot;
+
+    if ( _spareScanSnapshot && (_spareScanSnapshot.use_count() == 1) && (_spareScanSnapshot->capacity >= count) )
     {
-      LOGDEBUG(F("WIFI_SCAN_RUNNING!"));
+      snapshot = std::move(_spareScanSnapshot);
     }
-    else if (n < 0)
+    else
     {
-      LOGDEBUG(F("Failed, unknown error code!"));
+      _spareScanSnapshot.reset();
+
+      snapshot = std::make_shared<WiFiScanSnapshot>();
+
+      // Round up, so that small variations in the number of APs still fit next time
+      snapshot->capacity  = (count + 7) & ~7;
+      snapshot->results   = new WiFiResult[snapshot->capacity];
     }
-    else if (n == 0)
+
+    WiFiResult *results = snapshot->results;
+
+    // Already sorted by average RSSI. The recycled SSID Strings are reused, mostly without reallocating
+    for (wifi_ssid_count_t i = 0; i < count; i++)
     {
-      LOGDEBUG(F("No network found"));
-      // page += F("No networks found. Refresh to scan again.");
+      results[i] = _scanCache->results[i];
     }
-    else
+
+    // remove duplicates ( must be RSSI sorted )
+    if (_removeDuplicateAPs)
     {
-      if (wifiSSIDscan)
-      {
-        /* WE SHOULD MOVE THIS IN PLACE ATOMICALLY */
-        if (wifiSSIDs)
-          delete [] wifiSSIDs;
+      markDuplicateAPs(results, count);
+    }
 
-        wifiSSIDs     = new WiFiResult[n];
-        wifiSSIDCount = n;
+    snapshot->count = count;
 
-        if (n > 0)
-          shouldscan = false;
+    // Readers holding the old snapshot keep using it, it's recycled or freed after they're done
+    _spareScanSnapshot = std::atomic_exchange(&_scanSnapshot, snapshot);
 
-        for (wifi_ssid_count_t i = 0; i < n; i++)
-        {
-          wifiSSIDs[i].duplicate = false;
+#if USE_WM_EVENTS
+    sendScanEvent(count);
+#endif
+
+#if USE_WM_RENDER_CACHE
+    invalidateRendered();
+#endif
+
+    if (n > 0)
+      shouldscan = false;
+  }
+}
+
+//////////////////////////////////////////
+
+// Merge the n results of the last scan into _scanCache, by BSSID.
+// Then drop the networks not seen for WM_SCAN_CACHE_MAX_AGE, and sort the rest by average RSSI.
+void ESPAsync_WiFiManager::mergeScanResults(const wifi_ssid_count_t& n)
+{
+  if (!_scanCache)
+  {
+    _scanCache = new WiFiScanCache();
+
+    if (!_scanCache)
+    {
+      LOGERROR(F("mergeScanResults: Can't allocate scan cache"));
+
+      return;
+    }
+  }
+
+  WiFiScanCache *cache      = _scanCache;
+  WiFiResult    *results    = cache->results;
+  int32_t       *average    = cache->averageRSSI;
+  uint32_t      now         = millis();
+
+  String        ssid;
+  uint8_t       encryptionType;
+  int32_t       RSSI;
+  uint8_t       *bssid;
+  int32_t       channel;
+  bool          isHidden    = false;
+
+  for (wifi_ssid_count_t i = 0; i < n; i++)
+  {
+    bssid = NULL;
 
 #if defined(ESP8266)
-          WiFi.getNetworkInfo(i, wifiSSIDs[i].SSID, wifiSSIDs[i].encryptionType, wifiSSIDs[i].RSSI, wifiSSIDs[i].BSSID,
-                              wifiSSIDs[i].channel, wifiSSIDs[i].isHidden);
+    WiFi.getNetworkInfo(i, ssid, encryptionType, RSSI, bssid, channel, isHidden);
 #else
-          WiFi.getNetworkInfo(i, wifiSSIDs[i].SSID, wifiSSIDs[i].encryptionType, wifiSSIDs[i].RSSI, wifiSSIDs[i].BSSID,
-                              wifiSSIDs[i].channel);
+    WiFi.getNetworkInfo(i, ssid, encryptionType, RSSI, bssid, channel);
 #endif
-        }
 
-        // RSSI SORT
-        // old sort
-        for (int i = 0; i < n; i++)
-        {
-          for (int j = i + 1; j < n; j++)
-          {
-            if (wifiSSIDs[j].RSSI > wifiSSIDs[i].RSSI)
-            {
-              std::swap(wifiSSIDs[i], wifiSSIDs[j]);
-            }
-          }
-        }
+    if (!bssid)
+      continue;
+
+    wifi_ssid_count_t j = 0;
+
+    while ( (j < cache->count) && (memcmp(results[j].BSSID, bssid, sizeof(results[j].BSSID)) != 0) )
+      j++;
+
+    if (j == cache->count)
+    {
+      if (cache->count < WM_SCAN_CACHE_SIZE)
+      {
+        cache->count++;
+      }
+      else
+      {
+        // Full : replace the least recently seen network, the weakest one of them
+        j = 0;
 
-        // remove duplicates ( must be RSSI sorted )
-        if (_removeDuplicateAPs)
+        for (wifi_ssid_count_t k = 1; k < cache->count; k++)
         {
-          String cssid;
+          int32_t age = (int32_t) (results[j].lastSeen - results[k].lastSeen);
 
-          for (int i = 0; i < n; i++)
-          {
-            if (wifiSSIDs[i].duplicate == true)
-              continue;
-
-            cssid = wifiSSIDs[i].SSID;
-
-            for (int j = i + 1; j < n; j++)
-            {
-              if (cssid == wifiSSIDs[j].SSID)
-              {
-                LOGDEBUG("DUP AP: " + wifiSSIDs[j].SSID);
-                // set dup aps to NULL
-                wifiSSIDs[j].duplicate = true;
-              }
-            }
-          }
+          if ( (age > 0) || ( (age == 0) && (average[k] < average[j]) ) )
+            j = k;
         }
+
+        // All seen by this scan already, more networks around than WM_SCAN_CACHE_SIZE
+        if (results[j].lastSeen == now)
+          continue;
+      }
+
+      memcpy(results[j].BSSID, bssid, sizeof(results[j].BSSID));
+
+      results[j].hits = 0;
+      average[j]      = RSSI * 16;
+    }
+    else
+    {
+      average[j] += (RSSI * 16 - average[j]) / (1 << WM_SCAN_RSSI_SHIFT);
+    }
+
+    results[j].duplicate      = false;
+    results[j].SSID           = ssid;
+    results[j].encryptionType = encryptionType;
+    results[j].channel        = channel;
+    results[j].isHidden       = isHidden;
+    results[j].lastSeen       = now;
+
+    // Rounded to the nearest dBm
+    results[j].RSSI           = (average[j] - 8) / 16;
+
+    if (results[j].hits < 0xFFFF)
+      results[j].hits++;
+  }
+
+  // Age out, keeping the order
+  wifi_ssid_count_t count = 0;
+
+  for (wifi_ssid_count_t j = 0; j < cache->count; j++)
+  {
+    if (now - results[j].lastSeen > WM_SCAN_CACHE_MAX_AGE)
+    {
+      LOGDEBUG1(F("Scan cache: forget"), results[j].SSID);
+
+      continue;
+    }
+
+    if (count != j)
+    {
+      results[count]  = std::move(results[j]);
+      average[count]  = average[j];
+    }
+
+    count++;
+  }
+
+  cache->count = count;
+
+  // Insertion sort, stable. The averages move little from a scan to the next, so the cache is
+  // nearly sorted already and this is close to a single pass
+  for (wifi_ssid_count_t i = 1; i < count; i++)
+  {
+    if (average[i - 1] >= average[i])
+      continue;
+
+    WiFiResult  result  = std::move(results[i]);
+    int32_t     rssi    = average[i];
+    int         j       = i;
+
+    while ( (j > 0) && (average[j - 1] < rssi) )
+    {
+      results[j]  = std::move(results[j - 1]);
+      average[j]  = average[j - 1];
+      j--;
+    }
+
+    results[j]  = std::move(result);
+    average[j]  = rssi;
+  }
+
+  LOGDEBUG3(F("Scan cache: found ="), n, F(", cached ="), count);
+}
+
+//////////////////////////////////////////
+
+// Strongest AP of the last scan with this SSID, NULL if none.
+// The result points into snapshot, valid as long as the caller holds it
+const WiFiResult* ESPAsync_WiFiManager::findScannedAP(const WiFiScanSnapshotPtr& snapshot, const String& ssid)
+{
+  if (!snapshot)
+    return NULL;
+
+  // Results are RSSI sorted, the first match is the strongest
+  for (wifi_ssid_count_t i = 0; i < snapshot->count; i++)
+  {
+    const WiFiResult& result = snapshot->results[i];
+
+    if ( (result.channel > 0) && (result.SSID == ssid) )
+      return &result;
+  }
+
+  return NULL;
+}
+
+//////////////////////////////////////////
+
+// Single pass over the RSSI sorted results[], using an open-addressing hash set of SSIDs.
+// The first (strongest) AP of each SSID is kept, all the following ones are marked as duplicate.
+void ESPAsync_WiFiManager::markDuplicateAPs(WiFiResult *results, const wifi_ssid_count_t& n)
+{
+  // Power of 2, at least twice the number of APs, to keep the probe sequences short
+  uint16_t tableSize = 4;
+
+  while (tableSize < 2 * n)
+    tableSize <<= 1;
+
+  // One block for the SSID hashes and the table slots. A slot holds (index + 1), 0 means empty
+  uint8_t *block = (uint8_t *) malloc(n * sizeof(uint32_t) + tableSize * sizeof(uint16_t));
+
+  if (block == NULL)
+  {
+    LOGERROR(F("markDuplicateAPs: Can't allocate hash table"));
+
+    return;
+  }
+
+  uint32_t *hashes  = (uint32_t *) block;
+  uint16_t *slots   = (uint16_t *) (block + n * sizeof(uint32_t));
+
+  memset(slots, 0, tableSize * sizeof(uint16_t));
+
+  for (wifi_ssid_count_t i = 0; i < n; i++)
+  {
+    uint32_t hash = hashName(results[i].SSID.c_str());
+
+    hashes[i] = hash;
+
+    uint16_t slot = hash & (tableSize - 1);
+
+    while (slots[slot] != 0)
+    {
+      uint16_t j = slots[slot] - 1;
+
+      if ( (hashes[j] == hash) && (results[j].SSID == results[i].SSID) )
+      {
+        LOGDEBUG("DUP AP: " + results[i].SSID);
+
+        results[i].duplicate = true;
+        break;
       }
+
+      slot = (slot + 1) & (tableSize - 1);
     }
+
+    if (!results[i].duplicate)
+      slots[slot] = i + 1;
   }
+
+  free(block);
 }
 
 //////////////////////////////////////////
@@ -751,10 +2828,16 @@ void ESPAsync_WiFiManager::criticalLoop()
     {
       LOGDEBUG(F("criticalLoop: modeless scan"));
 
-      scan();
+      startAsyncScan();
       scannow = millis();
     }
 
+    pollAsyncScan();
+
+#if USE_WM_EVENTS
+    sendStatusEvent();
+#endif
+
     if (connect)
     {
       connect = false;
@@ -762,7 +2845,18 @@ void ESPAsync_WiFiManager::criticalLoop()
       LOGDEBUG(F("criticalLoop: Connecting to new AP"));
 
       // using user-provided  _ssid, _pass in place of system-stored ssid and pass
-      if (connectWifi(_ssid, _pass) != WL_CONNECTED)
+      int connRes = connectWifi(_ssid, _pass);
+
+#if USE_WM_EVENTS
+      sendSaveEvent(connRes);
+#endif
+
+#if USE_WM_RENDER_CACHE
+      // The attempt is over, even if no WiFi event came
+      invalidateRendered();
+#endif
+
+      if (connRes != WL_CONNECTED)
       {
         LOGDEBUG(F("criticalLoop: Failed to connect."));
       }
@@ -801,6 +2895,9 @@ void ESPAsync_WiFiManager::criticalLoop()
 
 void ESPAsync_WiFiManager::safeLoop()
 {
+#if USE_WM_DEFERRED_LOG
+  ESPAsync_WMlog.drain(DBG_PORT_ESP_WM);
+#endif
 }
 
 ///////////////////////////////////////////////////////////
@@ -863,16 +2960,22 @@ bool ESPAsync_WiFiManager::startConfigPortal(char const *apName, char const *apP
       // since we are modal, we can scan every time
       shouldscan = true;
 
+      // we might still be connecting, so that has to stop for scanning.
+      // No need to drop an already established connection.
+      if (WiFi.status() != WL_CONNECTED)
+      {
 #if defined(ESP8266)
-      // we might still be connecting, so that has to stop for scanning
-      ETS_UART_INTR_DISABLE ();
-      wifi_station_disconnect ();
-      ETS_UART_INTR_ENABLE ();
+        ETS_UART_INTR_DISABLE ();
+        wifi_station_disconnect ();
+        ETS_UART_INTR_ENABLE ();
 #else
-      WiFi.disconnect (false);
+        WiFi.disconnect (false);
 #endif
+      }
 
-      scan();
+      // Don't block the portal loop for the 2-4s of a scan. HTTP handlers keep serving
+      // the previous results until pollAsyncScan() swaps the new ones in
+      startAsyncScan();
 
       //if (_tryConnectDuringConfigPortal)
       //  WiFi.begin(); // try to reconnect to AP
@@ -880,8 +2983,18 @@ bool ESPAsync_WiFiManager::startConfigPortal(char const *apName, char const *apP
       scannow = millis() ;
     }
 
+    pollAsyncScan();
+
 #endif    // ( USING_ESP32_S2 || USING_ESP32_C3 )
 
+#if USE_WM_DEFERRED_LOG
+    ESPAsync_WMlog.drain(DBG_PORT_ESP_WM);
+#endif
+
+#if USE_WM_EVENTS
+    sendStatusEvent();
+#endif
+
     // yield before processing our flags "connect" and/or "stopConfigPortal"
     yield();
 
@@ -890,10 +3003,21 @@ bool ESPAsync_WiFiManager::startConfigPortal(char const *apName, char const *apP
       TimedOut = false;
       delay(2000);
 
-      LOGERROR(F("Connecting to new AP"));
+      LOGERROR(F("Connecting to new AP"));
+
+      // using user-provided  _ssid, _pass in place of system-stored ssid and pass
+      int connRes = connectWifi(_ssid, _pass);
+
+#if USE_WM_EVENTS
+      sendSaveEvent(connRes);
+#endif
+
+#if USE_WM_RENDER_CACHE
+      // The attempt is over, even if no WiFi event came
+      invalidateRendered();
+#endif
 
-      // using user-provided  _ssid, _pass in place of system-stored ssid and pass
-      if (connectWifi(_ssid, _pass) != WL_CONNECTED)
+      if (connRes != WL_CONNECTED)
       {
         LOGERROR(F("Failed to connect"));
 
@@ -959,11 +3083,26 @@ bool ESPAsync_WiFiManager::startConfigPortal(char const *apName, char const *apP
     LOGERROR1("Timed out connection result:", getStatus(connRes));
   }
 
+#if USE_WM_CAPTIVE_DNS
+  _captiveDNS.stop();
+#endif
+
+#if USE_WM_RENDER_CACHE
+  unsubscribeRendered();
+#endif
+
 #if !( USING_ESP32_S2 || USING_ESP32_C3 )
   server->reset();
+
+#if !USE_WM_CAPTIVE_DNS
   dnsServer->stop();
 #endif
 
+#if USE_WM_EVENTS
+  _events = NULL;
+#endif
+#endif
+
   return  (WiFi.status() == WL_CONNECTED);
 }
 
@@ -1086,7 +3225,21 @@ int ESPAsync_WiFiManager::connectWifi(const String& ssid, const String& pass)
       // Start Wifi with new values.
       LOGWARN(F("Connect to new WiFi using new IP parameters"));
 
-      WiFi.begin(ssid.c_str(), pass.c_str());
+      // The AP was most likely picked from our last scan. Passing its BSSID and channel
+      // saves the full channel scan WiFi.begin() would do otherwise
+      const WiFiScanSnapshotPtr snapshot  = getScanSnapshot();
+      const WiFiResult *scannedAP         = findScannedAP(snapshot, ssid);
+
+      if (scannedAP)
+      {
+        LOGWARN3(F("Using scanned AP, channel ="), scannedAP->channel, F(", RSSI ="), scannedAP->RSSI);
+
+        WiFi.begin(ssid.c_str(), pass.c_str(), scannedAP->channel, scannedAP->BSSID);
+      }
+      else
+      {
+        WiFi.begin(ssid.c_str(), pass.c_str());
+      }
     }
     else
     {
@@ -1120,59 +3273,32 @@ int ESPAsync_WiFiManager::connectWifi(const String& ssid, const String& pass)
 
 wl_status_t ESPAsync_WiFiManager::waitForConnectResult()
 {
+  WM_SPAN("waitForConnectResult");
+
   if (_connectTimeout == 0)
   {
-    unsigned long startedAt = millis();
-
-    // In ESP8266, WiFi.waitForConnectResult() @return wl_status_t (0-255) or -1 on timeout !!!
-    // In ESP32, WiFi.waitForConnectResult() @return wl_status_t (0-255)
-    // So, using int for connRes to be safe
-    //int connRes = WiFi.waitForConnectResult();
-    WiFi.waitForConnectResult();
-
-    float waited = (millis() - startedAt);
-
-    LOGWARN1(F("Connected after waiting (s) :"), waited / 1000);
-    LOGWARN1(F("Local ip ="), WiFi.localIP());
-
-    // Fix bug, connRes is sometimes not correct.
-    //return connRes;
-    return WiFi.status();
+    _connectWaiter.begin(WM_DEFAULT_CONNECT_TIMEOUT);
   }
   else
   {
     LOGERROR(F("Waiting WiFi connection with time out"));
 
-    unsigned long start = millis();
-    bool keepConnecting = true;
-    wl_status_t status;
-
-    while (keepConnecting)
-    {
-      status = WiFi.status();
-
-      if (millis() > start + _connectTimeout)
-      {
-        keepConnecting = false;
-
-        LOGERROR(F("Connection timed out"));
-      }
-
-#if ( ESP8266 && (USING_ESP8266_CORE_VERSION >= 30000) )
+    _connectWaiter.begin(_connectTimeout);
+  }
 
-      if (status == WL_CONNECTED || status == WL_CONNECT_FAILED || status == WL_WRONG_PASSWORD)
+#if USE_WM_EVENTS
+  // Report the connection progress to the portal pages
+  wl_status_t status = _connectWaiter.wait([this]()
+  {
+    sendStatusEvent();
+  });
 #else
-      if (status == WL_CONNECTED || status == WL_CONNECT_FAILED)
+  wl_status_t status = _connectWaiter.wait();
 #endif
-      {
-        keepConnecting = false;
-      }
 
-      delay(100);
-    }
+  LOGWARN1(F("Local ip ="), WiFi.localIP());
 
-    return status;
-  }
+  return status;
 }
 
 //////////////////////////////////////////
@@ -1382,104 +3508,405 @@ void ESPAsync_WiFiManager::setMinimumSignalQuality(const int& quality)
   _minimumQuality = quality;
 }
 
-//////////////////////////////////////////
+//////////////////////////////////////////
+
+void ESPAsync_WiFiManager::setBreakAfterConfig(bool shouldBreak)
+{
+  _shouldBreakAfterConfig = shouldBreak;
+}
+
+//////////////////////////////////////////
+
+void ESPAsync_WiFiManager::reportStatus(String& page)
+{
+  page += FPSTR(WM_HTTP_SCRIPT_NTP_MSG);
+
+  if (WiFi_SSID() != "")
+  {
+    page += F("Configurado para connectar ao AP <b>");
+    page += WiFi_SSID();
+
+    if (WiFi.status() == WL_CONNECTED)
+    {
+      page += F(" and connected</b> on IP <a href=\"http://");
+      page += WiFi.localIP().toString();
+      page += F("/\">");
+      page += WiFi.localIP().toString();
+      page += F("</a>");
+    }
+    else
+    {
+      page += F(" mas não conecdado.</b>");
+    }
+  }
+  else
+  {
+    page += F("No network configured.");
+  }
+}
+
+//////////////////////////////////////////
+
+// Handle root or redirect to captive portal
+void ESPAsync_WiFiManager::handleRoot(AsyncWebServerRequest *request)
+{
+  LOGDEBUG(F("Handle root"));
+
+  // Disable _configPortalTimeout when someone accessing Portal to give some time to config
+  _configPortalTimeout = 0;
+
+  if (captivePortal(request))
+  {
+    // If captive portal redirect instead of displaying the error page.
+    return;
+  }
+
+#if USE_WM_RENDER_CACHE
+  if (sendRendered(request, WM_RENDER_ROOT))
+    return;
+#endif
+
+  ESPAsync_WMPageStreamPtr stream = std::make_shared<ESPAsync_WMPageStream>();
+
+  streamHead(*stream, "Options", true);
+  stream->addP(WM_HTTP_HEAD_END);
+
+  String page = "<h2>";
+  page += _apName;
+
+  if (WiFi_SSID() != "")
+  {
+    if (WiFi.status() == WL_CONNECTED)
+    {
+      page += " on ";
+      page += WiFi_SSID();
+    }
+    else
+    {
+      page += " <s>on ";
+      page += WiFi_SSID();
+      page += "</s>";
+    }
+  }
+
+  page += "</h2>";
+
+  stream->add(page);
+  stream->addP(WM_FLDSET_START);
+  stream->addP(WM_HTTP_PORTAL_OPTIONS);
+
+  page = F("<div class=\"msg\">");
+
+  reportStatus(page);
+
+  page += F("</div>");
+
+  stream->add(page);
+  stream->addP(WM_FLDSET_END);
+  stream->addP(WM_HTTP_END);
+
+  sendStream(request, stream, WM_HTTP_HEAD_CT, WM_RENDER_ROOT);
+}
+
+//////////////////////////////////////////
+
+// Wifi config page handler
+void ESPAsync_WiFiManager::handleWifi(AsyncWebServerRequest *request)
+{
+  LOGDEBUG(F("Handle WiFi"));
+
+  // Disable _configPortalTimeout when someone accessing Portal to give some time to config
+  _configPortalTimeout = 0;
+
+  ESPAsync_WMPageStreamPtr stream = std::make_shared<ESPAsync_WMPageStream>();
+
+  streamHead(*stream, "Config ESP", true);
+  stream->addP(WM_HTTP_HEAD_END);
+  stream->add(F("<h2>Configuração</h2>"));
+
+#if !( USING_ESP32_S2 || USING_ESP32_C3 )
+
+#if USE_WM_EVENTS
+  // Network list, redrawn by WM_HTTP_EVENTS_WIFI_SCRIPT
+  stream->add(F("<div id='nl'>"));
+#endif
+
+  LOGDEBUG(F("handleWifi: Scan done"));
+
+  // The snapshot is held by the stream until the page is completely sent
+  WiFiScanSnapshotPtr snapshot = getScanSnapshot();
+
+  if (!snapshot || (snapshot->count == 0))
+  {
+    LOGDEBUG(F("handleWifi: No network found"));
+
+    stream->add(F("No network found. Refresh to scan again."));
+  }
+  else
+  {
+    stream->addP(WM_FLDSET_START);
+
+    int minimumQuality = _minimumQuality;
+
+    //display networks in page, one item at a time. Only the snapshot and values, not this :
+    //the response may still be sent after the portal returned and the manager is gone
+    stream->addItems([snapshot, minimumQuality](String & item, const int& index) -> bool
+    {
+      if (index >= snapshot->count)
+        return false;
+
+      networkItemAsString(item, snapshot->results[index], minimumQuality);
+
+      return true;
+    });
+
+    stream->addP(WM_FLDSET_END);
+    stream->add(F("<br/>"));
+  }
+
+#if USE_WM_EVENTS
+  stream->add(F("</div>"));
+  stream->addP(WM_HTTP_EVENTS_WIFI_SCRIPT);
+#endif
+
+#endif    // ( USING_ESP32_S2 || USING_ESP32_C3 )
+
+  stream->add(F("<small>*Dica: para reusar credenciais salvas, deixe o SSID e a SENHA vazia</small>"));
+
+#if DISPLAY_STORED_CREDENTIALS_IN_CP
+  // Populate SSIDs and PWDs if valid
+  String form;
+
+  const char* formValues[] = { _ssid.c_str(), _pass.c_str(), _ssid1.c_str(), _pass1.c_str() };
+
+  _formStartTemplate.render(form, formValues);
+
+  stream->add(form);
+#else
+  stream->addP(WM_HTTP_FORM_START);
+#endif
+
+  stream->addP(WM_FLDSET_START);
+
+  // add the extra parameters to the form. Rendered now, they belong to the manager and the sketch
+  String params;
+
+  for (int i = 0; (i < _paramsCount) && (_params[i] != NULL); i++)
+  {
+    String item;
+
+    paramAsString(item, _params[i]);
+    params += item;
+  }
+
+  stream->add(params);
+
+  if (_paramsCount > 0)
+  {
+    stream->addP(WM_FLDSET_END);
+  }
+
+  if (_params[0] != NULL)
+  {
+    stream->add(F("<br/>"));
+  }
+
+  LOGDEBUG1(F("Static IP ="), _WiFi_STA_IPconfig._sta_static_ip.toString());
+
+  // KH, Comment out to permit changing from DHCP to static IP, or vice versa
+  // and add staticIP label in CP
+
+  // To permit disable/enable StaticIP configuration in Config Portal from sketch. Valid only if DHCP is used.
+  // You'll loose the feature of dynamically changing from DHCP to static IP, or vice versa
+  // You have to explicitly specify false to disable the feature.
+
+#if !USE_STATIC_IP_CONFIG_IN_CP
+
+  if (_WiFi_STA_IPconfig._sta_static_ip)
+#endif
+  {
+    stream->addP(WM_FLDSET_START);
+
+    String item;
+
+    staticIPFieldAsString(item, "ip", "Static IP",  _WiFi_STA_IPconfig._sta_static_ip);
+    staticIPFieldAsString(item, "gw", "Gateway IP", _WiFi_STA_IPconfig._sta_static_gw);
+    staticIPFieldAsString(item, "sn", "Subnet",     _WiFi_STA_IPconfig._sta_static_sn);
+
+#if USE_CONFIGURABLE_DNS
+    //***** Added for DNS address options *****
+    staticIPFieldAsString(item, "dns1", "DNS1 IP", _WiFi_STA_IPconfig._sta_static_dns1);
+    staticIPFieldAsString(item, "dns2", "DNS2 IP", _WiFi_STA_IPconfig._sta_static_dns2);
+    //***** End added for DNS address options *****
+#endif
+
+    stream->add(item);
+    stream->addP(WM_FLDSET_END);
+    stream->add(F("<br/>"));
+  }
+
+  stream->addP(WM_HTTP_SCRIPT_NTP_HIDDEN);
+  stream->addP(WM_HTTP_FORM_END);
+  stream->addP(WM_HTTP_END);
+
+  sendStream(request, stream);
+
+  LOGDEBUG(F("Sent config page"));
+}
+
+//////////////////////////////////////////
+
+void ESPAsync_WiFiManager::paramAsString(String& item, ESPAsync_WMParameter* param)
+{
+  if (param->getID() == NULL)
+  {
+    item = param->getCustomHTML();
+
+    return;
+  }
+
+  char parLength[8];
+
+  snprintf(parLength, sizeof(parLength), "%d", param->getValueLength());
+
+  const char* values[] = { param->getID(), param->getID(), param->getPlaceholder(), parLength,
+                           param->getValue(), param->getCustomHTML() };
+
+  switch (param->getLabelPlacement())
+  {
+    case WFM_LABEL_BEFORE:
+      _labelBeforeTemplate.render(item, values);
+      break;
+
+    case WFM_LABEL_AFTER:
+      _labelAfterTemplate.render(item, values);
+      break;
+
+    default:
+      // WFM_NO_LABEL
+      _paramTemplate.render(item, values);
+      break;
+  }
+}
+
+//////////////////////////////////////////
+
+// Appends the label and input of one static IP field
+void ESPAsync_WiFiManager::staticIPFieldAsString(String& item, const char* id, const char* placeholder, const IPAddress& ip)
+{
+  String value = ip.toString();
+
+  const char* values[] = { id, id, placeholder, "15", value.c_str(), "" };
+
+  _labelTemplate.render(item, values);
+  _paramTemplate.render(item, values);
+}
+
+//////////////////////////////////////////
+
+// Common page head, up to but not including WM_HTTP_HEAD_END
+void ESPAsync_WiFiManager::streamHead(ESPAsync_WMPageStream& stream, const char* title, const bool& withNTP)
+{
+  String head;
+
+  const char* values[] = { title };
+
+  _headStartTemplate.render(head, values);
+
+  stream.add(head);
+
+#if USE_WM_GZIP_ASSETS
+  stream.addP(WM_ASSET_JS_TAG);
+
+  if (withNTP)
+  {
+  #if ( USE_ESP_WIFIMANAGER_NTP && !USE_CLOUDFLARE_NTP )
+    stream.addP(WM_ASSET_TZ_TAG);
+  #else
+    stream.addP(WM_HTTP_SCRIPT_NTP);
+  #endif
+  }
+
+  stream.addP(WM_ASSET_CSS_TAG);
+#else
+  stream.addP(WM_HTTP_SCRIPT);
+
+  if (withNTP)
+    stream.addP(WM_HTTP_SCRIPT_NTP);
+
+  stream.addP(WM_HTTP_STYLE);
+#endif
 
-void ESPAsync_WiFiManager::setBreakAfterConfig(bool shouldBreak)
-{
-  _shouldBreakAfterConfig = shouldBreak;
+  stream.add(_customHeadElement);
 }
 
 //////////////////////////////////////////
 
-void ESPAsync_WiFiManager::reportStatus(String& page)
+#if USE_WM_GZIP_ASSETS
+
+// Pre-gzipped asset from utils/WM_Assets.h, answered with 304 if the browser already has this version
+void ESPAsync_WiFiManager::handleAsset(AsyncWebServerRequest *request, const uint8_t* data, const size_t& length,
+                                       const char* contentType, const char* etag)
 {
-  page += FPSTR(WM_HTTP_SCRIPT_NTP_MSG);
+  AsyncWebServerResponse *response;
 
-  if (WiFi_SSID() != "")
+  AsyncWebHeader *ifNoneMatch = request->getHeader(WM_HTTP_IF_NONE_MATCH);
+
+  // If-None-Match may hold a list of ETags
+  if ( ifNoneMatch && (ifNoneMatch->value().indexOf(etag) >= 0) )
   {
-    page += F("Configurado para connectar ao AP <b>");
-    page += WiFi_SSID();
+    LOGDEBUG1(F("Asset not modified :"), request->url());
 
-    if (WiFi.status() == WL_CONNECTED)
-    {
-      page += F(" and connected</b> on IP <a href=\"http://");
-      page += WiFi.localIP().toString();
-      page += F("/\">");
-      page += WiFi.localIP().toString();
-      page += F("</a>");
-    }
-    else
-    {
-      page += F(" mas não conecdado.</b>");
-    }
+    response = request->beginResponse(304);
   }
   else
   {
-    page += F("No network configured.");
+    LOGDEBUG1(F("Asset :"), request->url());
+
+    response = request->beginResponse_P(200, contentType, data, length);
+    response->addHeader(WM_HTTP_CONTENT_ENCODING, WM_HTTP_GZIP);
+
+    countBytes(_metricsRoute, length);
   }
+
+  response->addHeader(WM_HTTP_ETAG, etag);
+  response->addHeader(WM_HTTP_CACHE_CONTROL, WM_HTTP_IMMUTABLE);
+
+  request->send(response);
 }
 
+#endif
+
 //////////////////////////////////////////
 
-// Handle root or redirect to captive portal
-void ESPAsync_WiFiManager::handleRoot(AsyncWebServerRequest *request)
+void ESPAsync_WiFiManager::sendStream(AsyncWebServerRequest *request, const ESPAsync_WMPageStreamPtr& stream,
+                                      const char* contentType, const uint8_t& cacheSlot)
 {
-  LOGDEBUG(F("Handle root"));
-
-  // Disable _configPortalTimeout when someone accessing Portal to give some time to config
-  _configPortalTimeout = 0;
+#if USE_WM_RENDER_CACHE
 
-  if (captivePortal(request))
-  {
-    // If captive portal redirect instead of displaying the error page.
+  // Still fresh unless an event came in while building the page. If not, just stream it this time
+  if ( (cacheSlot < WM_RENDER_COUNT) && keepRendered(cacheSlot, stream) && sendRendered(request, cacheSlot, contentType) )
     return;
-  }
 
-  String page = FPSTR(WM_HTTP_HEAD_START);
-  page.replace("{v}", "Options");
+#else
+  (void) cacheSlot;
+#endif
 
-  page += FPSTR(WM_HTTP_SCRIPT);
-  page += FPSTR(WM_HTTP_SCRIPT_NTP);
-  page += FPSTR(WM_HTTP_STYLE);
-  page += _customHeadElement;
-  page += FPSTR(WM_HTTP_HEAD_END);
-  page += "<h2>";
-  page += _apName;
+  uint8_t route = _metricsRoute;
 
-  if (WiFi_SSID() != "")
+  // The response owns a reference to the stream until the last chunk is sent
+  AsyncWebServerResponse *response = request->beginChunkedResponse(contentType,
+                                                                   [stream, route](uint8_t *buffer, size_t maxLen, size_t index) -> size_t
   {
-    if (WiFi.status() == WL_CONNECTED)
-    {
-      page += " on ";
-      page += WiFi_SSID();
-    }
-    else
-    {
-      page += " <s>on ";
-      page += WiFi_SSID();
-      page += "</s>";
-    }
-  }
-
-  page += "</h2>";
-  page += FPSTR(WM_FLDSET_START);
-  page += FPSTR(WM_HTTP_PORTAL_OPTIONS);
-  page += F("<div class=\"msg\">");
-
-  reportStatus(page);
+    (void) index;
 
-  page += F("</div>");
-  page += FPSTR(WM_FLDSET_END);
-  page += FPSTR(WM_HTTP_END);
+    size_t length = stream->fill(buffer, maxLen);
 
-#if ( USING_ESP32_S2 || USING_ESP32_C3 )
-  request->send(200, WM_HTTP_HEAD_CT, page);
+    countBytes(route, length);
 
-  // Fix ESP32-S2 issue with WebServer (https://github.com/espressif/arduino-esp32/issues/4348)
-  delay(1);
-#else
+    return length;
+  });
 
-  AsyncWebServerResponse *response = request->beginResponse(200, WM_HTTP_HEAD_CT, page);
   response->addHeader(FPSTR(WM_HTTP_CACHE_CONTROL), FPSTR(WM_HTTP_NO_STORE));
 
 #if USING_CORS_FEATURE
@@ -1492,379 +3919,438 @@ void ESPAsync_WiFiManager::handleRoot(AsyncWebServerRequest *request)
 
   request->send(response);
 
-#endif    // ( USING_ESP32_S2 || USING_ESP32_C3 )
+#if ( USING_ESP32_S2 || USING_ESP32_C3 )
+  // Fix ESP32-S2 issue with WebServer (https://github.com/espressif/arduino-esp32/issues/4348)
+  delay(1);
+#endif
 }
 
 //////////////////////////////////////////
 
-// Wifi config page handler
-void ESPAsync_WiFiManager::handleWifi(AsyncWebServerRequest *request)
+#if USE_WM_RENDER_CACHE
+
+// Once per portal, until unsubscribeRendered() when it stops or the manager is destroyed
+void ESPAsync_WiFiManager::subscribeRendered()
 {
-  LOGDEBUG(F("Handle WiFi"));
+#ifdef ESP8266
 
-  // Disable _configPortalTimeout when someone accessing Portal to give some time to config
-  _configPortalTimeout = 0;
+  if (!_renderGotIPHandler)
+  {
+    // Called from the SDK, only invalidate here
+    _renderGotIPHandler = WiFi.onStationModeGotIP([this](const WiFiEventStationModeGotIP & event)
+    {
+      (void) event;
 
-  String page = FPSTR(WM_HTTP_HEAD_START);
-  page.replace("{v}", "Config ESP");
+      invalidateRendered();
+    });
 
-  page += FPSTR(WM_HTTP_SCRIPT);
-  page += FPSTR(WM_HTTP_SCRIPT_NTP);
-  page += FPSTR(WM_HTTP_STYLE);
-  page += _customHeadElement;
-  page += FPSTR(WM_HTTP_HEAD_END);
-  page += F("<h2>Configuração</h2>");
+    _renderDisconnectedHandler = WiFi.onStationModeDisconnected([this](const WiFiEventStationModeDisconnected & event)
+    {
+      (void) event;
 
-#if !( USING_ESP32_S2 || USING_ESP32_C3 )
+      invalidateRendered();
+    });
+  }
 
-  wifiSSIDscan = false;
-  LOGDEBUG(F("handleWifi: Scan done"));
+#else
 
-  if (wifiSSIDCount == 0)
+  if (_renderEventID == 0)
   {
-    LOGDEBUG(F("handleWifi: No network found"));
+    // Called from the WiFi event task, only invalidate here
+    _renderEventID = WiFi.onEvent([this](WiFiEvent_t event, WiFiEventInfo_t info)
+    {
+      (void) info;
 
-    page += F("No network found. Refresh to scan again.");
+      if ( (event == WM_EVENT_STA_GOT_IP) || (event == WM_EVENT_STA_DISCONNECTED) )
+        invalidateRendered();
+    });
   }
-  else
-  {
-    page += FPSTR(WM_FLDSET_START);
 
-    //display networks in page
-    String pager = networkListAsString();
+#endif
+}
 
-    page += pager;
-    page += FPSTR(WM_FLDSET_END);
-    page += "<br/>";
-  }
+//////////////////////////////////////////
 
-  wifiSSIDscan = true;
+void ESPAsync_WiFiManager::unsubscribeRendered()
+{
+#ifdef ESP8266
+  _renderGotIPHandler.reset();
+  _renderDisconnectedHandler.reset();
+#else
+  if (_renderEventID != 0)
+  {
+    WiFi.removeEvent(_renderEventID);
+    _renderEventID = 0;
+  }
+#endif
+}
 
-#endif    // ( USING_ESP32_S2 || USING_ESP32_C3 )
+//////////////////////////////////////////
 
-  page += "<small>*Dica: para reusar credenciais salvas, deixe o SSID e a SENHA vazia</small>";
+// Serve the cached page of slot if it's still fresh. Returns false when it must be built again
+bool ESPAsync_WiFiManager::sendRendered(AsyncWebServerRequest *request, const uint8_t& slot, const char* contentType)
+{
+  const RenderedPage& rendered = _rendered[slot];
+  uint32_t            version  = _renderVersion;
 
-  page += FPSTR(WM_HTTP_FORM_START);
+  if ( !rendered.stream || (rendered.version != version) )
+  {
+    _renderingVersion = version;
 
-#if DISPLAY_STORED_CREDENTIALS_IN_CP
-  // Populate SSIDs and PWDs if valid
-  page.replace("[[ssid]]",  _ssid );
-  page.replace("[[pwd]]",   _pass );
-  page.replace("[[ssid1]]", _ssid1 );
-  page.replace("[[pwd1]]",  _pass1 );
-#endif
+    return false;
+  }
 
-  char parLength[2];
+  AsyncWebServerResponse *response;
 
-  page += FPSTR(WM_FLDSET_START);
+  AsyncWebHeader *ifNoneMatch = request->getHeader(WM_HTTP_IF_NONE_MATCH);
 
-  // add the extra parameters to the form
-  for (int i = 0; i < _paramsCount; i++)
+  // If-None-Match may hold a list of ETags
+  if ( ifNoneMatch && (ifNoneMatch->value().indexOf(rendered.etag) >= 0) )
   {
-    if (_params[i] == NULL)
-    {
-      break;
-    }
+    LOGDEBUG1(F("Not modified :"), request->url());
 
-    String pitem;
+    response = request->beginResponse(304);
+  }
+  else
+  {
+    ESPAsync_WMPageStreamPtr  stream  = rendered.stream;
+    uint8_t                   route   = _metricsRoute;
 
-    switch (_params[i]->getLabelPlacement())
+    // The response owns a reference to the page, even if a newer version replaces it meanwhile
+    response = request->beginResponse(contentType, rendered.length,
+                                      [stream, route](uint8_t *buffer, size_t maxLen, size_t index) -> size_t
     {
-      case WFM_LABEL_BEFORE:
-        pitem = FPSTR(WM_HTTP_FORM_LABEL_BEFORE);
-        break;
+      size_t length = stream->read(index, buffer, maxLen);
 
-      case WFM_LABEL_AFTER:
-        pitem = FPSTR(WM_HTTP_FORM_LABEL_AFTER);
-        break;
+      countBytes(route, length);
 
-      default:
-        // WFM_NO_LABEL
-        pitem = FPSTR(WM_HTTP_FORM_PARAM);
-        break;
-    }
+      return length;
+    });
+  }
 
-    if (_params[i]->getID() != NULL)
-    {
-      pitem.replace("{i}", _params[i]->getID());
-      pitem.replace("{n}", _params[i]->getID());
-      pitem.replace("{p}", _params[i]->getPlaceholder());
+  response->addHeader(FPSTR(WM_HTTP_ETAG), rendered.etag);
 
-      snprintf(parLength, 2, "%d", _params[i]->getValueLength());
+  // Stored, but revalidated every time
+  response->addHeader(FPSTR(WM_HTTP_CACHE_CONTROL), FPSTR(WM_HTTP_NO_CACHE));
 
-      pitem.replace("{l}", parLength);
-      pitem.replace("{v}", _params[i]->getValue());
-      pitem.replace("{c}", _params[i]->getCustomHTML());
-    }
-    else
-    {
-      pitem = _params[i]->getCustomHTML();
-    }
+#if USING_CORS_FEATURE
+  response->addHeader(FPSTR(WM_HTTP_CORS), _CORS_Header);
+#endif
 
-    page += pitem;
-  }
+  request->send(response);
 
-  if (_paramsCount > 0)
-  {
-    page += FPSTR(WM_FLDSET_END);
-  }
+#if ( USING_ESP32_S2 || USING_ESP32_C3 )
+  delay(1);
+#endif
 
-  if (_params[0] != NULL)
-  {
-    page += "<br/>";
-  }
+  return true;
+}
 
-  LOGDEBUG1(F("Static IP ="), _WiFi_STA_IPconfig._sta_static_ip.toString());
+//////////////////////////////////////////
 
-  // KH, Comment out to permit changing from DHCP to static IP, or vice versa
-  // and add staticIP label in CP
+// Keep the page just built for _renderingVersion in slot, with the FNV-1a of its content as ETag
+bool ESPAsync_WiFiManager::keepRendered(const uint8_t& slot, const ESPAsync_WMPageStreamPtr& stream)
+{
+  if (!stream->isStatic())
+    return false;
 
-  // To permit disable/enable StaticIP configuration in Config Portal from sketch. Valid only if DHCP is used.
-  // You'll loose the feature of dynamically changing from DHCP to static IP, or vice versa
-  // You have to explicitly specify false to disable the feature.
+  RenderedPage& rendered = _rendered[slot];
 
-#if !USE_STATIC_IP_CONFIG_IN_CP
+  uint8_t   buffer[64];
+  size_t    length  = 0;
+  size_t    len;
+  uint32_t  hash    = 2166136261UL;
 
-  if (_WiFi_STA_IPconfig._sta_static_ip)
-#endif
+  while ( (len = stream->read(length, buffer, sizeof(buffer))) > 0 )
   {
-    page += FPSTR(WM_FLDSET_START);
+    for (size_t i = 0; i < len; i++)
+    {
+      hash = (hash ^ buffer[i]) * 16777619UL;
+    }
 
-    String item = FPSTR(WM_HTTP_FORM_LABEL);
+    length += len;
+  }
 
-    item += FPSTR(WM_HTTP_FORM_PARAM);
+  rendered.stream   = stream;
+  rendered.length   = length;
+  rendered.version  = _renderingVersion;
 
-    item.replace("{i}", "ip");
-    item.replace("{n}", "ip");
-    item.replace("{p}", "Static IP");
-    item.replace("{l}", "15");
-    item.replace("{v}", _WiFi_STA_IPconfig._sta_static_ip.toString());
+  snprintf(rendered.etag, sizeof(rendered.etag), "\"%08x\"", (unsigned int) hash);
 
-    page += item;
+  LOGDEBUG3(F("Rendered page"), slot, F(", ETag ="), rendered.etag);
 
-    item = FPSTR(WM_HTTP_FORM_LABEL);
-    item += FPSTR(WM_HTTP_FORM_PARAM);
+  return true;
+}
 
-    item.replace("{i}", "gw");
-    item.replace("{n}", "gw");
-    item.replace("{p}", "Gateway IP");
-    item.replace("{l}", "15");
-    item.replace("{v}", _WiFi_STA_IPconfig._sta_static_gw.toString());
+#endif    // USE_WM_RENDER_CACHE
 
-    page += item;
+//////////////////////////////////////////
 
-    item = FPSTR(WM_HTTP_FORM_LABEL);
-    item += FPSTR(WM_HTTP_FORM_PARAM);
+#if USE_WM_EVENTS
 
-    item.replace("{i}", "sn");
-    item.replace("{n}", "sn");
-    item.replace("{p}", "Subnet");
-    item.replace("{l}", "15");
-    item.replace("{v}", _WiFi_STA_IPconfig._sta_static_sn.toString());
+void ESPAsync_WiFiManager::sendEvent(const char* event, const String& data)
+{
+  LOGDEBUG3(F("Event"), event, F(":"), data);
 
-#if USE_CONFIGURABLE_DNS
-    //***** Added for DNS address options *****
-    page += item;
+  _events->send(data.c_str(), event, millis());
+}
 
-    item = FPSTR(WM_HTTP_FORM_LABEL);
-    item += FPSTR(WM_HTTP_FORM_PARAM);
+//////////////////////////////////////////
 
-    item.replace("{i}", "dns1");
-    item.replace("{n}", "dns1");
-    item.replace("{p}", "DNS1 IP");
-    item.replace("{l}", "15");
-    item.replace("{v}", _WiFi_STA_IPconfig._sta_static_dns1.toString());
+// Called from the loops. Only reads the status, unless it changed and a page listens
+void ESPAsync_WiFiManager::sendStatusEvent()
+{
+  wl_status_t status = WiFi.status();
 
-    page += item;
+  if ( ((int) status == _eventStatus) || !hasEventClients() )
+    return;
 
-    item = FPSTR(WM_HTTP_FORM_LABEL);
-    item += FPSTR(WM_HTTP_FORM_PARAM);
+  _eventStatus = status;
 
-    item.replace("{i}", "dns2");
-    item.replace("{n}", "dns2");
-    item.replace("{p}", "DNS2 IP");
-    item.replace("{l}", "15");
-    item.replace("{v}", _WiFi_STA_IPconfig._sta_static_dns2.toString());
-    //***** End added for DNS address options *****
-#endif
+  String data;
+  ESPAsync_WMJsonWriter json(data);
 
-    page += item;
-    page += FPSTR(WM_FLDSET_END);
-    page += "<br/>";
-  }
+  json.beginObject()
+      .add(F("status"), (int) status)
+      .add(F("text"),   getStatus(status))
+      .add(F("ip"),     WiFi.localIP().toString())
+      .endObject();
 
-  page += FPSTR(WM_HTTP_SCRIPT_NTP_HIDDEN);
-  page += FPSTR(WM_HTTP_FORM_END);
-  page += FPSTR(WM_HTTP_END);
+  sendEvent("status", data);
+}
 
-#if ( USING_ESP32_S2 || USING_ESP32_C3 )
-  request->send(200, WM_HTTP_HEAD_CT, page);
+//////////////////////////////////////////
 
-  // Fix ESP32-S2 issue with WebServer (https://github.com/espressif/arduino-esp32/issues/4348)
-  delay(1);
-#else
+void ESPAsync_WiFiManager::sendScanEvent(const wifi_ssid_count_t& count)
+{
+  if (!hasEventClients())
+    return;
 
-  AsyncWebServerResponse *response = request->beginResponse(200, WM_HTTP_HEAD_CT, page);
+  String data;
+  ESPAsync_WMJsonWriter json(data);
 
-  response->addHeader(FPSTR(WM_HTTP_CACHE_CONTROL), FPSTR(WM_HTTP_NO_STORE));
+  json.beginObject()
+      .add(F("count"), (int) count)
+      .endObject();
 
-#if USING_CORS_FEATURE
-  response->addHeader(FPSTR(WM_HTTP_CORS), _CORS_Header);
-#endif
+  sendEvent("scan", data);
+}
 
-  response->addHeader(FPSTR(WM_HTTP_PRAGMA), FPSTR(WM_HTTP_NO_CACHE));
-  response->addHeader(FPSTR(WM_HTTP_EXPIRES), "-1");
+//////////////////////////////////////////
 
-  request->send(response);
+void ESPAsync_WiFiManager::sendSaveEvent(const int& status)
+{
+  // The attempt is over, resend the status too
+  _eventStatus = -1;
+  sendStatusEvent();
 
-#endif    // ( USING_ESP32_S2 || USING_ESP32_C3 )
+  if (!hasEventClients())
+    return;
 
-  LOGDEBUG(F("Sent config page"));
+  String data;
+  ESPAsync_WMJsonWriter json(data);
+
+  json.beginObject()
+      .add(F("connected"),  (status == WL_CONNECTED))
+      .add(F("ssid"),       _ssid)
+      .add(F("ip"),         WiFi.localIP().toString())
+      .endObject();
+
+  sendEvent("save", data);
 }
 
+#endif    // USE_WM_EVENTS
+
 //////////////////////////////////////////
 
-// Handle the WLAN save form and redirect to WLAN config page again
-void ESPAsync_WiFiManager::handleWifiSave(AsyncWebServerRequest *request)
+void ESPAsync_WiFiManager::addFormField(const char* name, const uint8_t& type, void* target, const int& length)
 {
-  LOGDEBUG(F("WiFi save"));
+  FormField field = { name, hashName(name), type, target, length };
 
-  //SAVE/connect here
-  _ssid = request->arg("s").c_str();
-  _pass = request->arg("p").c_str();
+  _formFields.push_back(field);
+}
 
-  _ssid1 = request->arg("s1").c_str();
-  _pass1 = request->arg("p1").c_str();
+//////////////////////////////////////////
 
-  ///////////////////////
+void ESPAsync_WiFiManager::buildFormFields()
+{
+  _formFields.clear();
 
-#if USE_ESP_WIFIMANAGER_NTP
+  addFormField("s",   WM_FORM_STRING, &_ssid);
+  addFormField("p",   WM_FORM_STRING, &_pass);
+  addFormField("s1",  WM_FORM_STRING, &_ssid1);
+  addFormField("p1",  WM_FORM_STRING, &_pass1);
 
-  if (request->hasArg("timezone"))
-  {
-    _timezoneName = request->arg("timezone");   //.c_str();
+#if USE_ESP_WIFIMANAGER_NTP
+  addFormField("timezone", WM_FORM_STRING, &_timezoneName);
+#endif
 
-    LOGDEBUG1(F("TZ ="), _timezoneName);
-  }
-  else
-  {
-    LOGDEBUG(F("No TZ arg"));
-  }
+  addFormField("ip",  WM_FORM_IP, &_WiFi_STA_IPconfig._sta_static_ip);
+  addFormField("gw",  WM_FORM_IP, &_WiFi_STA_IPconfig._sta_static_gw);
+  addFormField("sn",  WM_FORM_IP, &_WiFi_STA_IPconfig._sta_static_sn);
 
+#if USE_CONFIGURABLE_DNS
+  addFormField("dns1", WM_FORM_IP, &_WiFi_STA_IPconfig._sta_static_dns1);
+  addFormField("dns2", WM_FORM_IP, &_WiFi_STA_IPconfig._sta_static_dns2);
 #endif
 
-  ///////////////////////
-
-  //parameters
   for (int i = 0; i < _paramsCount; i++)
   {
     if (_params[i] == NULL)
-    {
       break;
-    }
-
-    //read parameter
-    String value = request->arg(_params[i]->getID()).c_str();
 
-    //store it in array
-    value.toCharArray(_params[i]->_WMParam_data._value, _params[i]->_WMParam_data._length);
+    // Custom HTML only, no input
+    if ( (_params[i]->getID() == NULL) || (_params[i]->_WMParam_data._value == NULL) )
+      continue;
 
-    LOGDEBUG2(F("Parameter and value :"), _params[i]->getID(), value);
+    addFormField(_params[i]->getID(), WM_FORM_VALUE, _params[i]->_WMParam_data._value, _params[i]->_WMParam_data._length);
   }
 
-  if (request->hasArg("ip"))
-  {
-    String ip = request->arg("ip");
+  // At most half full, to keep the probe sequences short
+  uint16_t tableSize = 8;
 
-    optionalIPFromString(&_WiFi_STA_IPconfig._sta_static_ip, ip.c_str());
+  while (tableSize < 2 * _formFields.size())
+    tableSize <<= 1;
 
-    LOGDEBUG1(F("New Static IP ="), _WiFi_STA_IPconfig._sta_static_ip.toString());
-  }
+  _formSlots.assign(tableSize, 0);
 
-  if (request->hasArg("gw"))
+  for (uint16_t i = 0; i < _formFields.size(); i++)
   {
-    String gw = request->arg("gw");
+    uint16_t slot = _formFields[i].hash & (tableSize - 1);
 
-    optionalIPFromString(&_WiFi_STA_IPconfig._sta_static_gw, gw.c_str());
+    while (_formSlots[slot] != 0)
+      slot = (slot + 1) & (tableSize - 1);
 
-    LOGDEBUG1(F("New Static Gateway ="), _WiFi_STA_IPconfig._sta_static_gw.toString());
+    _formSlots[slot] = i + 1;
   }
 
-  if (request->hasArg("sn"))
-  {
-    String sn = request->arg("sn");
+  _formFieldsValid = true;
+}
+
+//////////////////////////////////////////
+
+// One pass over the submitted arguments, each one stored straight into the fields bound to its name.
+// Like the former request->arg() lookups, missing credentials and parameters are read as empty,
+// missing timezone and IPs are left unchanged
+void ESPAsync_WiFiManager::decodeForm(AsyncWebServerRequest *request)
+{
+  if (!_formFieldsValid)
+    buildFormFields();
 
-    optionalIPFromString(&_WiFi_STA_IPconfig._sta_static_sn, sn.c_str());
+  _ssid   = "";
+  _pass   = "";
+  _ssid1  = "";
+  _pass1  = "";
 
-    LOGDEBUG1(F("New Static Netmask ="), _WiFi_STA_IPconfig._sta_static_sn.toString());
+  for (FormField& field : _formFields)
+  {
+    if (field.type == WM_FORM_VALUE)
+      ((char *) field.target)[0] = 0;
   }
 
-#if USE_CONFIGURABLE_DNS
+  uint16_t mask = _formSlots.size() - 1;
+  size_t   count = request->params();
 
-  //*****  Added for DNS Options *****
-  if (request->hasArg("dns1"))
+  for (size_t i = 0; i < count; i++)
   {
-    String dns1 = request->arg("dns1");
+    const AsyncWebParameter *param = request->getParam(i);
+
+    if ( (param == NULL) || param->isFile() )
+      continue;
+
+    const char  *name = param->name().c_str();
+    uint16_t    slot  = hashName(name) & mask;
+
+    // Duplicated parameter IDs each get the value, as before
+    for ( ; _formSlots[slot] != 0; slot = (slot + 1) & mask)
+    {
+      FormField& field = _formFields[_formSlots[slot] - 1];
+
+      if (strcmp(field.name, name) != 0)
+        continue;
+
+      const String& value = param->value();
 
-    optionalIPFromString(&_WiFi_STA_IPconfig._sta_static_dns1, dns1.c_str());
+      switch (field.type)
+      {
+        case WM_FORM_STRING:
+          *((String *) field.target) = value;
+          break;
+
+        case WM_FORM_VALUE:
+          if (field.length > 0)
+          {
+            char *buffer  = (char *) field.target;
+            size_t length = std::min((size_t) value.length(), (size_t) (field.length - 1));
+
+            memcpy(buffer, value.c_str(), length);
+            buffer[length] = 0;
+          }
+
+          break;
+
+        case WM_FORM_IP:
+          optionalIPFromString((IPAddress *) field.target, value.c_str());
+          break;
+      }
 
-    LOGDEBUG1(F("New Static DNS1 ="), _WiFi_STA_IPconfig._sta_static_dns1.toString());
+      // Never the WiFi passwords, the log may be kept in RAM and served on /log
+      if ( (field.target == &_pass) || (field.target == &_pass1) )
+      {
+        LOGDEBUG1(F("Form field :"), field.name);
+      }
+      else
+      {
+        LOGDEBUG2(F("Form field and value :"), field.name, value);
+      }
+    }
   }
+}
 
-  if (request->hasArg("dns2"))
-  {
-    String dns2 = request->arg("dns2");
+//////////////////////////////////////////
+
+// Handle the WLAN save form and redirect to WLAN config page again
+void ESPAsync_WiFiManager::handleWifiSave(AsyncWebServerRequest *request)
+{
+  LOGDEBUG(F("WiFi save"));
+
+  //SAVE/connect here
+  decodeForm(request);
 
-    optionalIPFromString(&_WiFi_STA_IPconfig._sta_static_dns2, dns2.c_str());
+#if USE_WM_KNOWN_NETWORKS
 
-    LOGDEBUG1(F("New Static DNS2 ="), _WiFi_STA_IPconfig._sta_static_dns2.toString());
+  if (_knownNetworks)
+  {
+    _knownNetworks->add(_ssid.c_str(), _pass.c_str());
+    _knownNetworks->add(_ssid1.c_str(), _pass1.c_str());
   }
 
-  //*****  End added for DNS Options *****
 #endif
 
-  String page = FPSTR(WM_HTTP_HEAD_START);
-  page.replace("{v}", "Credentials Saved");
-
-  page += FPSTR(WM_HTTP_SCRIPT);
-  page += FPSTR(WM_HTTP_STYLE);
-  page += _customHeadElement;
-  page += FPSTR(WM_HTTP_HEAD_END);
-  page += FPSTR(WM_HTTP_SAVED);
-
-  page.replace("{v}", _apName);
-  page.replace("{x}", _ssid);
-  page.replace("{x1}", _ssid1);
-  //////
-
-  page += FPSTR(WM_HTTP_END);
-
-  //LOGDEBUG1(F("page ="), page);
-
-#if ( USING_ESP32_S2 || USING_ESP32_C3 )
-  request->send(200, WM_HTTP_HEAD_CT, page);
+  ESPAsync_WMPageStreamPtr stream = std::make_shared<ESPAsync_WMPageStream>();
 
-  // Fix ESP32-S2 issue with WebServer (https://github.com/espressif/arduino-esp32/issues/4348)
-  delay(1);
-#else
+  streamHead(*stream, "Credentials Saved");
+  stream->addP(WM_HTTP_HEAD_END);
 
-  AsyncWebServerResponse *response = request->beginResponse(200, WM_HTTP_HEAD_CT, page);
-  response->addHeader(FPSTR(WM_HTTP_CACHE_CONTROL), FPSTR(WM_HTTP_NO_STORE));
+  String page;
 
-#if USING_CORS_FEATURE
-  response->addHeader(FPSTR(WM_HTTP_CORS), _CORS_Header);
-#endif
+  const char* values[] = { _apName, _ssid.c_str(), _ssid1.c_str() };
 
-  response->addHeader(FPSTR(WM_HTTP_PRAGMA), FPSTR(WM_HTTP_NO_CACHE));
-  response->addHeader(FPSTR(WM_HTTP_EXPIRES), "-1");
+  _savedTemplate.render(page, values);
 
-  request->send(response);
+  stream->add(page);
+  stream->addP(WM_HTTP_END);
 
-#endif    // ( USING_ESP32_S2 || USING_ESP32_C3 )
+  sendStream(request, stream);
 
   LOGDEBUG(F("Sent wifi save page"));
 
   connect = true; //signal ready to connect/reset
+
+#if USE_WM_RENDER_CACHE
+  // The info page now shows the attempt
+  invalidateRendered();
+#endif
 }
 
 //////////////////////////////////////////
@@ -1874,14 +4360,13 @@ void ESPAsync_WiFiManager::handleServerClose(AsyncWebServerRequest *request)
 {
   LOGDEBUG(F("Server Close"));
 
-  String page = FPSTR(WM_HTTP_HEAD_START);
-  page.replace("{v}", "Close Server");
+  ESPAsync_WMPageStreamPtr stream = std::make_shared<ESPAsync_WMPageStream>();
+
+  streamHead(*stream, "Close Server");
+  stream->addP(WM_HTTP_HEAD_END);
+
+  String page = F("<div class=\"msg\">");
 
-  page += FPSTR(WM_HTTP_SCRIPT);
-  page += FPSTR(WM_HTTP_STYLE);
-  page += _customHeadElement;
-  page += FPSTR(WM_HTTP_HEAD_END);
-  page += F("<div class=\"msg\">");
   page += F("My network is <b>");
   page += WiFi_SSID();
   page += F("</b><br>");
@@ -1892,28 +4377,10 @@ void ESPAsync_WiFiManager::handleServerClose(AsyncWebServerRequest *request)
 
   //page += F("Push button on device to restart configuration server!");
 
-  page += FPSTR(WM_HTTP_END);
-
-#if ( USING_ESP32_S2 || USING_ESP32_C3 )
-  request->send(200, WM_HTTP_HEAD_CT, page);
-
-  // Fix ESP32-S2 issue with WebServer (https://github.com/espressif/arduino-esp32/issues/4348)
-  delay(1);
-#else
-
-  AsyncWebServerResponse *response = request->beginResponse(200, WM_HTTP_HEAD_CT, page);
-  response->addHeader(FPSTR(WM_HTTP_CACHE_CONTROL), FPSTR(WM_HTTP_NO_STORE));
-
-#if USING_CORS_FEATURE
-  response->addHeader(FPSTR(WM_HTTP_CORS), _CORS_Header);
-#endif
-
-  response->addHeader(FPSTR(WM_HTTP_PRAGMA), FPSTR(WM_HTTP_NO_CACHE));
-  response->addHeader(FPSTR(WM_HTTP_EXPIRES), "-1");
-
-  request->send(response);
+  stream->add(page);
+  stream->addP(WM_HTTP_END);
 
-#endif    // ( USING_ESP32_S2 || USING_ESP32_C3 )
+  sendStream(request, stream);
 
   stopConfigPortal = true; //signal ready to shutdown config portal
 
@@ -1930,24 +4397,31 @@ void ESPAsync_WiFiManager::handleInfo(AsyncWebServerRequest *request)
   // Disable _configPortalTimeout when someone accessing Portal to give some time to config
   _configPortalTimeout = 0;
 
-  String page = FPSTR(WM_HTTP_HEAD_START);
-  page.replace("{v}", "Info");
+#if USE_WM_RENDER_CACHE
+  if (sendRendered(request, WM_RENDER_INFO))
+    return;
+#endif
+
+  ESPAsync_WMPageStreamPtr stream = std::make_shared<ESPAsync_WMPageStream>();
 
-  page += FPSTR(WM_HTTP_SCRIPT);
-  page += FPSTR(WM_HTTP_SCRIPT_NTP);
-  page += FPSTR(WM_HTTP_STYLE);
-  page += _customHeadElement;
+  streamHead(*stream, "Info", true);
 
   if (connect)
-    page += F("<meta http-equiv=\"refresh\" content=\"5; url=/i\">");
+  {
+#if USE_WM_EVENTS
+    stream->addP(WM_HTTP_EVENTS_INFO_SCRIPT);
+#else
+    stream->add(F("<meta http-equiv=\"refresh\" content=\"5; url=/i\">"));
+#endif
+  }
 
-  page += FPSTR(WM_HTTP_HEAD_END);
+  stream->addP(WM_HTTP_HEAD_END);
 
-  page += F("<dl>");
+  String page = F("<dl>");
 
   if (connect)
   {
-    page += F("<dt>Trying to connect</dt><dd>");
+    page += F("<dt>Trying to connect</dt><dd id='st'>");
     page += wifiStatus;
     page += F("</dd>");
   }
@@ -2029,39 +4503,20 @@ void ESPAsync_WiFiManager::handleInfo(AsyncWebServerRequest *request)
   page += F("</td></tr>");
   page += F("</tbody></table>");
 
-  page += FPSTR(WM_FLDSET_END);
+  stream->add(page);
+  stream->addP(WM_FLDSET_END);
 
 #if USE_AVAILABLE_PAGES
-  page += FPSTR(WM_FLDSET_START);
-  page += FPSTR(WM_HTTP_AVAILABLE_PAGES);
-  page += FPSTR(WM_FLDSET_END);
-#endif
-
-  page += F("<p/>More information about ESPAsync_WiFiManager at");
-  page += F("<p/><a href=\"https://github.com/khoih-prog/ESPAsync_WiFiManager\">https://github.com/khoih-prog/ESPAsync_WiFiManager</a>");
-  page += FPSTR(WM_HTTP_END);
-
-#if ( USING_ESP32_S2 || USING_ESP32_C3 )
-  request->send(200, WM_HTTP_HEAD_CT, page);
-
-  // Fix ESP32-S2 issue with WebServer (https://github.com/espressif/arduino-esp32/issues/4348)
-  delay(1);
-#else
-
-  AsyncWebServerResponse *response = request->beginResponse(200, WM_HTTP_HEAD_CT, page);
-
-  response->addHeader(FPSTR(WM_HTTP_CACHE_CONTROL), FPSTR(WM_HTTP_NO_STORE));
-
-#if USING_CORS_FEATURE
-  response->addHeader(FPSTR(WM_HTTP_CORS), _CORS_Header);
+  stream->addP(WM_FLDSET_START);
+  stream->addP(WM_HTTP_AVAILABLE_PAGES);
+  stream->addP(WM_FLDSET_END);
 #endif
 
-  response->addHeader(FPSTR(WM_HTTP_PRAGMA), FPSTR(WM_HTTP_NO_CACHE));
-  response->addHeader(FPSTR(WM_HTTP_EXPIRES), "-1");
-
-  request->send(response);
+  stream->add(F("<p/>More information about ESPAsync_WiFiManager at"));
+  stream->add(F("<p/><a href=\"https://github.com/khoih-prog/ESPAsync_WiFiManager\">https://github.com/khoih-prog/ESPAsync_WiFiManager</a>"));
+  stream->addP(WM_HTTP_END);
 
-#endif    // ( USING_ESP32_S2 || USING_ESP32_C3 )
+  sendStream(request, stream, WM_HTTP_HEAD_CT, WM_RENDER_INFO);
 
   LOGDEBUG(F("Info page sent"));
 }
@@ -2073,49 +4528,29 @@ void ESPAsync_WiFiManager::handleState(AsyncWebServerRequest *request)
 {
   LOGDEBUG(F("State-Json"));
 
-  String page = F("{\"Soft_AP_IP\":\"");
-
-  page += WiFi.softAPIP().toString();
-  page += F("\",\"Soft_AP_MAC\":\"");
-  page += WiFi.softAPmacAddress();
-  page += F("\",\"Station_IP\":\"");
-  page += WiFi.localIP().toString();
-  page += F("\",\"Station_MAC\":\"");
-  page += WiFi.macAddress();
-  page += F("\",");
-
-  if (WiFi.psk() != "")
-  {
-    page += F("\"Password\":true,");
-  }
-  else
-  {
-    page += F("\"Password\":false,");
-  }
-
-  page += F("\"SSID\":\"");
-  page += WiFi_SSID();
-  page += F("\"}");
-
-#if ( USING_ESP32_S2 || USING_ESP32_C3 )
-  request->send(200, WM_HTTP_HEAD_CT, page);
+#if USE_WM_RENDER_CACHE
+  if (sendRendered(request, WM_RENDER_STATE, WM_HTTP_HEAD_JSON))
+    return;
+#endif
 
-  // Fix ESP32-S2 issue with WebServer (https://github.com/espressif/arduino-esp32/issues/4348)
-  delay(1);
-#else
+  ESPAsync_WMPageStreamPtr stream(new ESPAsync_WMPageStream());
 
-  AsyncWebServerResponse *response = request->beginResponse(200, "application/json", page);
-  response->addHeader(FPSTR(WM_HTTP_CACHE_CONTROL), FPSTR(WM_HTTP_NO_STORE));
+  // Small, rendered now so that the page is static and can be cached
+  String page;
+  ESPAsync_WMJsonWriter json(page);
 
-#if USING_CORS_FEATURE
-  response->addHeader(FPSTR(WM_HTTP_CORS), _CORS_Header);
-#endif
+  json.beginObject()
+      .add(F("Soft_AP_IP"),   WiFi.softAPIP().toString())
+      .add(F("Soft_AP_MAC"),  WiFi.softAPmacAddress())
+      .add(F("Station_IP"),   WiFi.localIP().toString())
+      .add(F("Station_MAC"),  WiFi.macAddress())
+      .add(F("Password"),     (WiFi.psk() != ""))
+      .add(F("SSID"),         WiFi_SSID())
+      .endObject();
 
-  response->addHeader(FPSTR(WM_HTTP_PRAGMA), FPSTR(WM_HTTP_NO_CACHE));
-  response->addHeader(FPSTR(WM_HTTP_EXPIRES), "-1");
+  stream->add(page);
 
-  request->send(response);
-#endif    // ( USING_ESP32_S2 || USING_ESP32_C3 )
+  sendStream(request, stream, WM_HTTP_HEAD_JSON, WM_RENDER_STATE);
 
   LOGDEBUG(F("Sent state page in json format"));
 }
@@ -2132,72 +4567,68 @@ void ESPAsync_WiFiManager::handleScan(AsyncWebServerRequest *request)
 
   LOGDEBUG(F("Scan-Json"));
 
-  String page = F("{\"Access_Points\":[");
-
   // KH, display networks in page using previously scan results
-  for (int i = 0; i < wifiSSIDCount; i++)
-  {
-    if (wifiSSIDs[i].duplicate == true)
-      continue; // skip dups
+  WiFiScanSnapshotPtr snapshot = getScanSnapshot();
 
-    if (i != 0)
-      page += F(", ");
+  ESPAsync_WMPageStreamPtr stream(new ESPAsync_WMPageStream());
 
-    LOGDEBUG1(F("Index ="), i);
-    LOGDEBUG1(F("SSID ="), wifiSSIDs[i].SSID);
-    LOGDEBUG1(F("RSSI ="), wifiSSIDs[i].RSSI);
+  stream->add(F("{\"Access_Points\":["));
 
-    int quality = getRSSIasQuality(wifiSSIDs[i].RSSI);
+  if (snapshot)
+  {
+    // Networks written so far. The stream keeps its own copy of the generator, so it lasts for the whole response
+    int written         = 0;
+    int minimumQuality  = _minimumQuality;
 
-    if (_minimumQuality == -1 || _minimumQuality < quality)
+    // Not this : the response may still be sent after the portal returned and the manager is gone
+    stream->addItems([snapshot, written, minimumQuality](String & item, const int& index) mutable -> bool
     {
-      String item = FPSTR(JSON_ITEM);
-      String rssiQ;
+      if (index >= snapshot->count)
+        return false;
 
-      rssiQ += quality;
-      item.replace("{v}", wifiSSIDs[i].SSID);
-      item.replace("{r}", rssiQ);
+      const WiFiResult& result = snapshot->results[index];
 
-#if defined(ESP8266)
+      if (result.duplicate == true)
+        return true;    // skip dups
 
-      if (wifiSSIDs[i].encryptionType != ENC_TYPE_NONE)
-#else
-      if (wifiSSIDs[i].encryptionType != WIFI_AUTH_OPEN)
-#endif
-      {
-        item.replace("{i}", "true");
-      }
-      else
+      LOGDEBUG1(F("Index ="), index);
+      LOGDEBUG1(F("SSID ="), result.SSID);
+      LOGDEBUG1(F("RSSI ="), result.RSSI);
+
+      int quality = getRSSIasQuality(result.RSSI);
+
+      if ( (minimumQuality != -1) && (minimumQuality >= quality) )
       {
-        item.replace("{i}", "false");
-      }
+        LOGDEBUG(F("Skipping due to quality"));
 
-      page += item;
-      delay(0);
-    }
-    else
-    {
-      LOGDEBUG(F("Skipping due to quality"));
-    }
-  }
+        return true;
+      }
 
-  page += F("]}");
+      char rssiQ[8];
 
-#if ( USING_ESP32_S2 || USING_ESP32_C3 )
-  request->send(200, WM_HTTP_HEAD_CT, page);
+      snprintf(rssiQ, sizeof(rssiQ), "%d", quality);
 
-  // Fix ESP32-S2 issue with WebServer (https://github.com/espressif/arduino-esp32/issues/4348)
-  delay(1);
+#if defined(ESP8266)
+      bool encrypted = (result.encryptionType != ENC_TYPE_NONE);
 #else
+      bool encrypted = (result.encryptionType != WIFI_AUTH_OPEN);
+#endif
 
-  AsyncWebServerResponse *response = request->beginResponse(200, WM_HTTP_HEAD_JSON, page);
+      ESPAsync_WMJsonWriter json(item, (written++ > 0));
 
-  response->addHeader(WM_HTTP_CACHE_CONTROL, WM_HTTP_NO_STORE);
-  response->addHeader(WM_HTTP_PRAGMA, WM_HTTP_NO_CACHE);
-  response->addHeader(WM_HTTP_EXPIRES, "-1");
+      json.beginObject()
+          .add(F("SSID"),       result.SSID)
+          .add(F("Encryption"), encrypted)
+          .add(F("Quality"),    rssiQ)
+          .endObject();
 
-  request->send(response);
-#endif    // ( USING_ESP32_S2 || USING_ESP32_C3 )  
+      return true;
+    });
+  }
+
+  stream->add(F("]}"));
+
+  sendStream(request, stream, WM_HTTP_HEAD_JSON);
 
   LOGDEBUG(F("Sent WiFiScan Data in Json format"));
 }
@@ -2209,28 +4640,14 @@ void ESPAsync_WiFiManager::handleReset(AsyncWebServerRequest *request)
 {
   LOGDEBUG(F("Reset"));
 
-  String page = FPSTR(WM_HTTP_HEAD_START);
-  page.replace("{v}", "WiFi Information");
-
-  page += FPSTR(WM_HTTP_SCRIPT);
-  page += FPSTR(WM_HTTP_STYLE);
-  page += _customHeadElement;
-  page += FPSTR(WM_HTTP_HEAD_END);
-  page += F("Resetting");
-  page += FPSTR(WM_HTTP_END);
-
-#if ( USING_ESP32_S2 || USING_ESP32_C3 )
-  request->send(200, WM_HTTP_HEAD_CT, page);
-#else
+  ESPAsync_WMPageStreamPtr stream = std::make_shared<ESPAsync_WMPageStream>();
 
-  AsyncWebServerResponse *response = request->beginResponse(200, WM_HTTP_HEAD_CT, page);
-
-  response->addHeader(WM_HTTP_CACHE_CONTROL, WM_HTTP_NO_STORE);
-  response->addHeader(WM_HTTP_PRAGMA, WM_HTTP_NO_CACHE);
-  response->addHeader(WM_HTTP_EXPIRES, "-1");
+  streamHead(*stream, "WiFi Information");
+  stream->addP(WM_HTTP_HEAD_END);
+  stream->add(F("Resetting"));
+  stream->addP(WM_HTTP_END);
 
-  request->send(response);
-#endif    // ( USING_ESP32_S2 || USING_ESP32_C3 )
+  sendStream(request, stream);
 
   LOGDEBUG(F("Sent reset page"));
   delay(5000);
@@ -2252,6 +4669,191 @@ void ESPAsync_WiFiManager::handleReset(AsyncWebServerRequest *request)
 
 //////////////////////////////////////////
 
+ArRequestHandlerFunction ESPAsync_WiFiManager::measured(const uint8_t& route, const ArRequestHandlerFunction& handler)
+{
+#if ( USE_WM_METRICS || USE_WM_ADMISSION )
+  return [this, route, handler](AsyncWebServerRequest * request)
+  {
+#if USE_WM_ADMISSION
+    if (!admit(request, route))
+      return;
+#endif
+
+#if USE_WM_METRICS
+    uint32_t start = micros();
+
+    _metricsRoute = route;
+#endif
+
+    handler(request);
+
+#if USE_WM_METRICS
+    ESPAsync_WMmetrics.request(route, micros() - start);
+#endif
+  };
+#else
+  (void) route;
+
+  return handler;
+#endif
+}
+
+//////////////////////////////////////////
+
+ArRequestHandlerFunction ESPAsync_WiFiManager::measured(const uint8_t& route, RequestHandler handler)
+{
+  return measured(route, std::bind(handler, this, std::placeholders::_1));
+}
+
+//////////////////////////////////////////
+
+#if USE_WM_ADMISSION
+
+bool ESPAsync_WiFiManager::admit(AsyncWebServerRequest *request, const uint8_t& route)
+{
+  uint32_t cost = (route < WM_ROUTE_COUNT) ? WM_ADMISSION_COST[route] : 0;
+
+  if (cost == 0)
+    return true;
+
+  if (!_admission.admit(cost))
+  {
+    LOGDEBUG3(F("Busy, refused route"), route, F(", in flight bytes ="), _admission.inFlightBytes());
+
+    AsyncWebServerResponse *response = request->beginResponse_P(503, WM_HTTP_HEAD_CT, WM_HTTP_BUSY_PAGE);
+
+    response->addHeader(WM_HTTP_RETRY_AFTER, WM_ADMISSION_STR(WM_ADMISSION_RETRY_AFTER));
+    response->addHeader(FPSTR(WM_HTTP_CACHE_CONTROL), FPSTR(WM_HTTP_NO_STORE));
+
+    request->send(response);
+
+    return false;
+  }
+
+  // Called when the connection closes, after the response was sent or when the client went away
+  request->onDisconnect([this, cost]()
+  {
+    _admission.release(cost);
+  });
+
+  return true;
+}
+
+#endif    // USE_WM_ADMISSION
+
+//////////////////////////////////////////
+
+#if USE_WM_METRICS
+
+void ESPAsync_WiFiManager::handleMetrics(AsyncWebServerRequest *request)
+{
+  LOGDEBUG(F("Metrics"));
+
+  AsyncResponseStream *response = request->beginResponseStream(WM_HTTP_CT_METRICS);
+
+  // Counts the bytes written to the response
+  class CountingPrint : public Print
+  {
+    public:
+
+      CountingPrint(Print& out) : _out(out)
+      {
+      }
+
+      using Print::write;
+
+      size_t write(uint8_t c) override
+      {
+        size_t n = _out.write(c);
+
+        bytes += n;
+
+        return n;
+      }
+
+      size_t write(const uint8_t *buffer, size_t size) override
+      {
+        size_t n = _out.write(buffer, size);
+
+        bytes += n;
+
+        return n;
+      }
+
+      size_t bytes = 0;
+
+    private:
+
+      Print& _out;
+  } out(*response);
+
+  ESPAsync_WMmetrics.write(out);
+
+#if USE_WM_ADMISSION
+  _admission.write(out);
+#endif
+
+  response->addHeader(WM_HTTP_CACHE_CONTROL, WM_HTTP_NO_STORE);
+
+  countBytes(_metricsRoute, out.bytes);
+
+  request->send(response);
+}
+
+#endif    // USE_WM_METRICS
+
+//////////////////////////////////////////
+
+#if ( USE_WM_DEFERRED_LOG && USE_WM_LOG_ROUTE )
+
+// Records still in the log ring, as text. ?level=2 for errors and warnings only
+void ESPAsync_WiFiManager::handleLog(AsyncWebServerRequest *request)
+{
+  uint8_t level = 4;
+
+  if (request->hasArg("level"))
+    level = request->arg("level").toInt();
+
+  AsyncResponseStream *response = request->beginResponseStream(WM_HTTP_HEAD_CT2);
+
+  countBytes(_metricsRoute, ESPAsync_WMlog.write(*response, level));
+
+  response->addHeader(WM_HTTP_CACHE_CONTROL, WM_HTTP_NO_STORE);
+
+  request->send(response);
+}
+
+#endif    // ( USE_WM_DEFERRED_LOG && USE_WM_LOG_ROUTE )
+
+//////////////////////////////////////////
+
+#if USE_WM_TIMELINE
+
+void ESPAsync_WiFiManager::handleTimeline(AsyncWebServerRequest *request)
+{
+  LOGDEBUG(F("Timeline-Json"));
+
+  String page;
+
+  ESPAsync_WMtimeline.toJSON(page);
+
+  countBytes(_metricsRoute, page.length());
+
+  AsyncWebServerResponse *response = request->beginResponse(200, WM_HTTP_HEAD_JSON, page);
+
+  response->addHeader(FPSTR(WM_HTTP_CACHE_CONTROL), FPSTR(WM_HTTP_NO_STORE));
+
+#if USING_CORS_FEATURE
+  response->addHeader(FPSTR(WM_HTTP_CORS), _CORS_Header);
+#endif
+
+  request->send(response);
+}
+
+#endif    // USE_WM_TIMELINE
+
+//////////////////////////////////////////
+
 void ESPAsync_WiFiManager::handleNotFound(AsyncWebServerRequest *request)
 {
   if (captivePortal(request))
@@ -2275,6 +4877,8 @@ void ESPAsync_WiFiManager::handleNotFound(AsyncWebServerRequest *request)
     message += " " + request->argName(i) + ": " + request->arg(i) + "\n";
   }
 
+  countBytes(_metricsRoute, message.length());
+
 #if ( USING_ESP32_S2 || USING_ESP32_C3 )
   request->send(200, WM_HTTP_HEAD_CT, message);
 
@@ -2294,6 +4898,21 @@ void ESPAsync_WiFiManager::handleNotFound(AsyncWebServerRequest *request)
 
 //////////////////////////////////////////
 
+// OS connectivity probe : redirect to the portal, so that the OS shows it right away
+void ESPAsync_WiFiManager::handleProbe(AsyncWebServerRequest *request)
+{
+  AsyncWebServerResponse *response = request->beginResponse(302, WM_HTTP_HEAD_CT2, "");
+
+  response->addHeader(FPSTR(WM_HTTP_LOCATION), _portalLocation);
+
+  // Not cached, the OS must probe again once the device is configured
+  response->addHeader(FPSTR(WM_HTTP_CACHE_CONTROL), FPSTR(WM_HTTP_NO_STORE));
+
+  request->send(response);
+}
+
+//////////////////////////////////////////
+
 /**
    HTTPD redirector
    Redirect to captive portal if we got a request for another domain.
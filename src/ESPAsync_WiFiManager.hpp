@@ -226,6 +226,7 @@
 #undef max
 
 #include <algorithm>
+#include <vector>
 
 ////////////////////////////////////////////////////
 
@@ -249,6 +250,22 @@
 #else   //ESP32
 
   #include <esp_wifi.h>
+
+  #include <freertos/FreeRTOS.h>
+  #include <freertos/semphr.h>
+
+  #include <atomic>
+
+  // WiFi event names changed in core v2.0.0
+  #if ( defined(ESP_ARDUINO_VERSION_MAJOR) && (ESP_ARDUINO_VERSION_MAJOR >= 2) )
+    #define WM_EVENT_STA_CONNECTED        ARDUINO_EVENT_WIFI_STA_CONNECTED
+    #define WM_EVENT_STA_GOT_IP           ARDUINO_EVENT_WIFI_STA_GOT_IP
+    #define WM_EVENT_STA_DISCONNECTED     ARDUINO_EVENT_WIFI_STA_DISCONNECTED
+  #else
+    #define WM_EVENT_STA_CONNECTED        SYSTEM_EVENT_STA_CONNECTED
+    #define WM_EVENT_STA_GOT_IP           SYSTEM_EVENT_STA_GOT_IP
+    #define WM_EVENT_STA_DISCONNECTED     SYSTEM_EVENT_STA_DISCONNECTED
+  #endif
   
   uint32_t getChipID();
   uint32_t getChipOUI();
@@ -319,6 +336,26 @@ typedef struct
   #define TIME_BETWEEN_MODELESS_SCANS       120000UL
 #endif
 
+#ifndef TIME_MAX_ASYNC_SCAN
+  // Give up a background scan not completed after 10s
+  #define TIME_MAX_ASYNC_SCAN               10000UL
+#endif
+
+// Networks remembered across scans, keyed by BSSID
+#ifndef WM_SCAN_CACHE_SIZE
+  #define WM_SCAN_CACHE_SIZE                32
+#endif
+
+// Forget a network not seen by any scan for that long. Default to 2 missed scans
+#ifndef WM_SCAN_CACHE_MAX_AGE
+  #define WM_SCAN_CACHE_MAX_AGE             (5 * TIME_BETWEEN_MODAL_SCANS / 2)
+#endif
+
+// Weight of a new RSSI sample in the average, 1 / 2^WM_SCAN_RSSI_SHIFT
+#ifndef WM_SCAN_RSSI_SHIFT
+  #define WM_SCAN_RSSI_SHIFT                2
+#endif
+
 ////////////////////////////////////////////////////
 
 //KH
@@ -348,6 +385,7 @@ const char WM_HTTP_SCRIPT[] PROGMEM = "<script>function c(l){document.getElement
 #if USE_ESP_WIFIMANAGER_NTP
 
 #include "utils/TZ.h"
+#include "utils/TZ_Index.h"
 
 const char WM_HTTP_SCRIPT_NTP_MSG[] PROGMEM = "<p>Your Timezone is : <b><label id='timezone' name='timezone'></b><script>document.getElementById('timezone').innerHTML=timezone.name();document.getElementById('timezone').value=timezone.name();</script></p>";
 const char WM_HTTP_SCRIPT_NTP_HIDDEN[] PROGMEM = "<p><input type='hidden' id='timezone' name='timezone'><script>document.getElementById('timezone').innerHTML=timezone.name();document.getElementById('timezone').value=timezone.name();</script></p>";
@@ -385,6 +423,19 @@ const char WM_HTTP_SCRIPT_NTP[] PROGMEM = "<script>(function(e){var t=function()
   const char WM_HTTP_SCRIPT_NTP[]         PROGMEM   = "";
 #endif
 
+////////////////////////////////////////////////////
+
+// To serve WM_HTTP_STYLE, WM_HTTP_SCRIPT and the jstz WM_HTTP_SCRIPT_NTP as separate, pre-gzipped and
+// cacheable /wm.css, /wm.js and /tz.js instead of inlining them in every page.
+// The assets are in utils/assets. Regenerate utils/WM_Assets.h with utils/gen_assets.py after changing them.
+#ifndef USE_WM_GZIP_ASSETS
+  #define USE_WM_GZIP_ASSETS          true
+#endif
+
+#if USE_WM_GZIP_ASSETS
+  #include "utils/WM_Assets.h"
+#endif
+
 ////////////////////////////////////////////////////
 ////////////////////////////////////////////////////
 
@@ -399,7 +450,6 @@ const char WM_FLDSET_END[]    PROGMEM = "</fieldset>";
 
 const char WM_HTTP_PORTAL_OPTIONS[] PROGMEM = "<form action='/wifi' method='get'><button class='btn'>Configuração</button></form><br/><form action='/i' method='get'><button class='btn'>Informações</button></form><br/><form action='/close' method='get'><button class='btn'>Sair do Portal</button></form><br/>";
 const char WM_HTTP_ITEM[] PROGMEM = "<div><a href='#p' onclick='c(this)'>{v}</a>&nbsp;<span class='q {i}'>{r}%</span></div>";
-const char JSON_ITEM[] PROGMEM    = "{\"SSID\":\"{v}\", \"Encryption\":{i}, \"Quality\":\"{r}\"}";
 
 ////////////////////////////////////////////////////
 
@@ -461,6 +511,28 @@ const char WM_HTTP_EXPIRES[]         = "Expires";
 const char WM_HTTP_CORS[]            = "Access-Control-Allow-Origin";
 const char WM_HTTP_CORS_ALLOW_ALL[]  = "*";
 
+const char WM_HTTP_CT_CSS[]           = "text/css";
+const char WM_HTTP_CT_JS[]            = "application/javascript";
+const char WM_HTTP_ETAG[]             = "ETag";
+const char WM_HTTP_IF_NONE_MATCH[]    = "If-None-Match";
+const char WM_HTTP_LOCATION[]         = "Location";
+
+// OS connectivity probes, redirected straight to the portal : Android, Apple, Windows, Firefox
+const char* const WM_CAPTIVE_PROBES[] =
+{
+  "/generate_204", "/gen_204",
+  "/hotspot-detect.html", "/library/test/success.html",
+  "/ncsi.txt", "/connecttest.txt", "/redirect",
+  "/canonical.html", "/success.txt"
+};
+const char WM_HTTP_CONTENT_ENCODING[] = "Content-Encoding";
+const char WM_HTTP_GZIP[]             = "gzip";
+// Assets are linked with their ETag in the URL, so a cached copy never goes stale
+const char WM_HTTP_IMMUTABLE[]        = "public, max-age=31536000, immutable";
+
+// Prometheus text exposition format
+const char WM_HTTP_CT_METRICS[]       = "text/plain; version=0.0.4";
+
 ////////////////////////////////////////////////////
 
 #if USE_AVAILABLE_PAGES
@@ -496,6 +568,57 @@ typedef struct
 ////////////////////////////////////////////////////
 ////////////////////////////////////////////////////
 
+class ESPAsync_WMParameter;
+
+// One heap block for the value buffers of a portal session's parameters, and for the manager's
+// parameter table (see ESPAsync_WiFiManager::setParamArena()). Freed at once by the destructor,
+// instead of one new[] per parameter and the reallocs of the table fragmenting the heap.
+// Declare it before the parameters and the manager, so that it outlives them.
+class ESPAsync_WMParamArena
+{
+  public:
+
+    // valueBytes : sum of the parameters' length + 1
+    ESPAsync_WMParamArena(const uint8_t& maxParams, const size_t& valueBytes);
+    ~ESPAsync_WMParamArena();
+
+    // NULL when full, or when the block couldn't be allocated
+    char*                   allocValue(const int& length);
+
+    inline ESPAsync_WMParameter** table()
+    {
+      return (ESPAsync_WMParameter**) _block;
+    }
+
+    inline uint8_t maxParams()
+    {
+      return _block ? _maxParams : 0;
+    }
+
+    // Bytes allocated, and used by the table and the values so far
+    inline size_t size()
+    {
+      return _block ? _size : 0;
+    }
+
+    inline size_t used()
+    {
+      return _block ? _used : 0;
+    }
+
+  private:
+
+    uint8_t       *_block;
+    size_t        _size;
+    size_t        _used;
+    uint8_t       _maxParams;
+
+    ESPAsync_WMParamArena(const ESPAsync_WMParamArena&);
+    ESPAsync_WMParamArena& operator=(const ESPAsync_WMParamArena&);
+};
+
+////////////////////////////////////////////////////
+
 class ESPAsync_WMParameter 
 {
   public:
@@ -503,6 +626,10 @@ class ESPAsync_WMParameter
     ESPAsync_WMParameter(const char *custom);
     ESPAsync_WMParameter(const char *id, const char *placeholder, const char *defaultValue, const int& length, 
                          const char *custom = "", const int& labelPlacement = WFM_LABEL_BEFORE);
+
+    // Value buffer taken from arena, or from the heap if it's full
+    ESPAsync_WMParameter(ESPAsync_WMParamArena& arena, const char *id, const char *placeholder, const char *defaultValue,
+                         const int& length, const char *custom = "", const int& labelPlacement = WFM_LABEL_BEFORE);
                                            
     ESPAsync_WMParameter(const WMParam_Data& WMParam_data);                      
     
@@ -524,8 +651,11 @@ class ESPAsync_WMParameter
     
     const char *_customHTML;
 
+    // _value belongs to an arena, not to be deleted
+    bool        _inArena    = false;
+
     void init(const char *id, const char *placeholder, const char *defaultValue, const int& length, 
-              const char *custom, const int& labelPlacement);
+              const char *custom, const int& labelPlacement, ESPAsync_WMParamArena* arena = NULL);
 
     friend class ESPAsync_WiFiManager;
 };
@@ -551,15 +681,747 @@ class WiFiResult
     String SSID;
     uint8_t encryptionType;
     int32_t RSSI;
-    uint8_t* BSSID;
+    uint8_t BSSID[6];     // Copied, the driver's scan records are freed by the next scan
     int32_t channel;
     bool isHidden;
+    uint16_t hits;        // Number of scans that saw it
+    uint32_t lastSeen;    // millis() of the last scan that saw it
 
     WiFiResult()
     {
     }
 };
 
+////////////////////////////////////////////////////
+
+// Networks seen by the recent scans, one entry per BSSID. Each scan is merged into it, so a network
+// missing from a single scan stays listed, and RSSI is averaged over the scans.
+// Kept sorted by average RSSI, strongest first.
+class WiFiScanCache
+{
+  public:
+    WiFiResult          results[WM_SCAN_CACHE_SIZE];
+    int32_t             averageRSSI[WM_SCAN_CACHE_SIZE];    // EWMA, in 1/16 dBm
+    wifi_ssid_count_t   count = 0;
+
+    WiFiScanCache()
+    {
+    }
+
+  private:
+
+    WiFiScanCache(const WiFiScanCache&);
+    WiFiScanCache& operator=(const WiFiScanCache&);
+};
+
+////////////////////////////////////////////////////
+
+// Immutable once published. Handlers hold a WiFiScanSnapshotPtr for as long as they read it,
+// the results are freed (or recycled for the next scan) when the last holder releases it.
+class WiFiScanSnapshot
+{
+  public:
+    WiFiResult          *results  = NULL;
+    wifi_ssid_count_t   count     = 0;
+    wifi_ssid_count_t   capacity  = 0;
+
+    WiFiScanSnapshot()
+    {
+    }
+
+    ~WiFiScanSnapshot()
+    {
+      if (results)
+        delete [] results;
+    }
+
+  private:
+
+    WiFiScanSnapshot(const WiFiScanSnapshot&);
+    WiFiScanSnapshot& operator=(const WiFiScanSnapshot&);
+};
+
+typedef std::shared_ptr<WiFiScanSnapshot>   WiFiScanSnapshotPtr;
+
+////////////////////////////////////////////////////
+////////////////////////////////////////////////////
+
+// Page renderer for AsyncWebServerRequest::beginChunkedResponse().
+// A page is a list of sections. PROGMEM sections are copied straight into the TCP send buffer,
+// item sections are rendered one item at a time on demand. So the heap used by a request is
+// bounded by the largest item, not by the size of the whole page.
+class ESPAsync_WMPageStream
+{
+  public:
+
+    // Render item #index into item (already empty). Leave it empty to skip this index.
+    // Return false when there is no item left.
+    typedef std::function<bool(String& item, const int& index)> ItemGenerator;
+
+    ESPAsync_WMPageStream();
+
+    // PROGMEM text, must stay valid until the response is sent
+    void          addP(PGM_P text);
+    void          add(const __FlashStringHelper* text);
+
+    // Copied, for small dynamic text
+    void          add(const String& text);
+    void          add(const char* text);
+
+    void          addItems(const ItemGenerator& generator);
+
+    // AwsResponseFiller. Returns 0 when the page is complete
+    size_t        fill(uint8_t *buffer, const size_t& maxLen);
+
+    inline size_t bytesSent()
+    {
+      return _bytesSent;
+    }
+
+    // Without items, the whole page is known in advance. It can then also be read at any offset,
+    // independently of fill(), by any number of responses at once
+    bool          isStatic() const;
+    size_t        length() const;
+    size_t        read(const size_t& index, uint8_t *buffer, const size_t& maxLen) const;
+
+  private:
+
+#define WM_STREAM_PROGMEM       0
+#define WM_STREAM_TEXT          1
+#define WM_STREAM_ITEMS         2
+
+    typedef struct
+    {
+      uint8_t   type;
+      PGM_P     text;       // WM_STREAM_PROGMEM
+      size_t    offset;     // WM_STREAM_TEXT : offset in _text. WM_STREAM_ITEMS : index in _generators
+      size_t    length;
+    } Section;
+
+    std::vector<Section>        _sections;
+    std::vector<ItemGenerator>  _generators;
+
+    String        _text;          // All the copied small texts
+    String        _item;          // Item being sent
+
+    size_t        _section        = 0;
+    size_t        _sectionOffset  = 0;
+    int           _itemIndex      = 0;
+    size_t        _bytesSent      = 0;
+};
+
+typedef std::shared_ptr<ESPAsync_WMPageStream>   ESPAsync_WMPageStreamPtr;
+
+////////////////////////////////////////////////////
+////////////////////////////////////////////////////
+
+// JSON writer appending to a String, normally the item being rendered by an ESPAsync_WMPageStream,
+// so a document is escaped and sent as it is generated. Commas are inserted automatically.
+// Keys are flash strings and are not escaped, values always are.
+class ESPAsync_WMJsonWriter
+{
+  public:
+
+    // separated : the first value follows elements already sent, e.g. by a previous item
+    ESPAsync_WMJsonWriter(String& out, const bool& separated = false);
+
+    // key is NULL for array elements and for the top level value
+    ESPAsync_WMJsonWriter&  beginObject(const __FlashStringHelper* key = NULL);
+    ESPAsync_WMJsonWriter&  endObject();
+    ESPAsync_WMJsonWriter&  beginArray(const __FlashStringHelper* key = NULL);
+    ESPAsync_WMJsonWriter&  endArray();
+
+    ESPAsync_WMJsonWriter&  add(const __FlashStringHelper* key, const char* value);
+    ESPAsync_WMJsonWriter&  add(const __FlashStringHelper* key, const String& value);
+    ESPAsync_WMJsonWriter&  add(const __FlashStringHelper* key, const bool& value);
+    ESPAsync_WMJsonWriter&  add(const __FlashStringHelper* key, const int& value);
+
+    // Append text as a quoted JSON string
+    static void             addString(String& out, const char* text, const size_t& length);
+
+  private:
+
+    void          separate(const __FlashStringHelper* key);
+
+    String&       _out;
+    uint32_t      _nonEmpty;      // Bit per nesting level, set once the level holds an element
+    uint8_t       _depth          = 0;
+};
+
+////////////////////////////////////////////////////
+////////////////////////////////////////////////////
+
+// PROGMEM template with {name} or [[name]] placeholders, such as WM_HTTP_ITEM.
+// The template is split once, on first use, into literal and slot segments, so rendering is
+// a single forward write into the output String, instead of one String::replace() rescan per placeholder.
+class ESPAsync_WMTemplate
+{
+  public:
+
+    // slotNames : comma separated placeholder names, in the order of the values given to render(), e.g. "v,r,i".
+    // Placeholders not in slotNames are kept as is.
+    ESPAsync_WMTemplate(PGM_P text, const char* slotNames);
+    ~ESPAsync_WMTemplate();
+
+    // Appends the rendered template to out. A NULL value renders as empty
+    void          render(String& out, const char* const values[]);
+
+  private:
+
+    typedef struct
+    {
+      uint16_t  offset;   // in _text
+      uint16_t  length;
+      int8_t    slot;     // -1 for a literal segment
+    } Segment;
+
+    PGM_P         _text;
+    const char*   _slotNames;
+
+    Segment*      _segments       = NULL;
+    uint8_t       _segmentCount   = 0;
+    uint16_t      _literalLength  = 0;
+
+    bool          compile();
+    int8_t        slotIndex(const size_t& nameOffset, const size_t& nameLength);
+    void          appendLiteral(String& out, const Segment& segment);
+
+    ESPAsync_WMTemplate(const ESPAsync_WMTemplate&);
+    ESPAsync_WMTemplate& operator=(const ESPAsync_WMTemplate&);
+};
+
+////////////////////////////////////////////////////
+////////////////////////////////////////////////////
+
+// Used when no connect timeout is set, same as the cores' WiFi.waitForConnectResult()
+#ifndef WM_DEFAULT_CONNECT_TIMEOUT
+  #if ESP8266
+    #define WM_DEFAULT_CONNECT_TIMEOUT      60000UL
+  #else
+    #define WM_DEFAULT_CONNECT_TIMEOUT      10000UL
+  #endif
+#endif
+
+// Completion of a station connection attempt, signalled by the WiFi events (got IP, disconnected)
+// instead of polling WiFi.status(). Arm it with begin() right after WiFi.begin() or wifiMulti.run(), then
+// either block with wait(), or call poll() from loop() and get the result through the callback.
+class ESPAsync_WMConnectWaiter
+{
+  public:
+
+    typedef std::function<void(const wl_status_t& status)> ConnectCallback;
+
+    ESPAsync_WMConnectWaiter();
+    ~ESPAsync_WMConnectWaiter();
+
+    // The callback is called once, from poll() or wait(), never from the WiFi event context
+    void          begin(const unsigned long& timeout = WM_DEFAULT_CONNECT_TIMEOUT, const ConnectCallback& callback = nullptr);
+
+    // Non-blocking. Returns true once connected, failed (bad password) or timed out
+    bool          poll();
+
+    // Blocks until poll() is done. idle, if any, is called while waiting, e.g. to keep serving DRD or MQTT
+    wl_status_t   wait(const std::function<void()>& idle = nullptr);
+
+    void          cancel();
+
+    inline bool isPending()
+    {
+      return _pending;
+    }
+
+    // Result of the last completed attempt
+    inline wl_status_t status()
+    {
+      return _status;
+    }
+
+    // The station joined the AP since begin(), even if it didn't get an IP yet.
+    // Tells a DHCP timeout apart from a wrong BSSID, channel or password
+    bool          joined();
+
+  private:
+
+    volatile bool   _gotIP          = false;
+    volatile bool   _disconnected   = false;
+    volatile bool   _joined         = false;
+
+    bool            _pending        = false;
+    wl_status_t     _status         = WL_IDLE_STATUS;
+    unsigned long   _start          = 0;
+    unsigned long   _timeout        = 0;
+    ConnectCallback _callback;
+
+#ifdef ESP8266
+    WiFiEventHandler  _gotIPHandler;
+    WiFiEventHandler  _disconnectedHandler;
+    WiFiEventHandler  _connectedHandler;
+#else
+    // The WiFi event task may still be running the handler while a waiter is destroyed. So it's
+    // registered once for all the waiters and never removed, and only counts the events. Each waiter
+    // compares the counts with the ones at its begin()
+    static volatile uint32_t  _gotIPEvents;
+    static volatile uint32_t  _disconnectedEvents;
+    static volatile uint32_t  _connectedEvents;
+    static wifi_event_id_t    _eventID;
+
+    // Given by the WiFi event task, so wait() sleeps until something happens. Never deleted
+    static SemaphoreHandle_t  _signal;
+
+    uint32_t          _gotIPSeen          = 0;
+    uint32_t          _disconnectedSeen   = 0;
+    uint32_t          _connectedSeen      = 0;
+#endif
+
+    void          subscribe();
+    void          unsubscribe();
+    void          complete(const wl_status_t& status);
+
+    ESPAsync_WMConnectWaiter(const ESPAsync_WMConnectWaiter&);
+    ESPAsync_WMConnectWaiter& operator=(const ESPAsync_WMConnectWaiter&);
+};
+
+////////////////////////////////////////////////////
+////////////////////////////////////////////////////
+
+// Boot / connection timeline : where the seconds before WL_CONNECTED actually go.
+// Spans are begin / end pairs with micros() timestamps, kept in a fixed RAM ring, the oldest being
+// overwritten once WM_TIMELINE_SIZE spans were recorded. Printed with print(), served as JSON on /timeline.
+#ifndef USE_WM_TIMELINE
+  #define USE_WM_TIMELINE           false
+#endif
+
+#if USE_WM_TIMELINE
+
+#ifndef WM_TIMELINE_SIZE
+  #define WM_TIMELINE_SIZE          24
+#endif
+
+// Duration of a span not ended yet
+#define WM_SPAN_OPEN                0xFFFFFFFFUL
+
+class ESPAsync_WMTimeline
+{
+  public:
+
+    typedef struct
+    {
+      const __FlashStringHelper*  name;
+      uint32_t                    id;
+      uint32_t                    start;      // micros()
+      uint32_t                    duration;   // us, WM_SPAN_OPEN until ended
+      uint8_t                     depth;      // Spans opened, and not ended, before this one
+    } Span;
+
+    // name must be a flash string, F("..."). Returns the id to end() it with
+    uint32_t      begin(const __FlashStringHelper* name);
+
+    // Ignored if the span was already overwritten in the ring
+    void          end(const uint32_t& id);
+
+    void          clear();
+
+    // Number of spans in the ring, span(0) being the oldest
+    uint8_t       count();
+    const Span*   span(const uint8_t& index);
+
+    void          print(Print& out);
+    void          toJSON(String& out);
+
+  private:
+
+    Span          _spans[WM_TIMELINE_SIZE];
+    uint32_t      _nextID     = 0;
+    uint8_t       _depth      = 0;
+};
+
+extern ESPAsync_WMTimeline ESPAsync_WMtimeline;
+
+// Ends the span when going out of scope
+class ESPAsync_WMSpan
+{
+  public:
+
+    ESPAsync_WMSpan(const __FlashStringHelper* name) : _id(ESPAsync_WMtimeline.begin(name))
+    {
+    }
+
+    ~ESPAsync_WMSpan()
+    {
+      ESPAsync_WMtimeline.end(_id);
+    }
+
+  private:
+
+    uint32_t      _id;
+};
+
+#define WM_SPAN(name)               ESPAsync_WMSpan _wmSpan(F(name))
+#define WM_SPAN_BEGIN(id, name)     uint32_t id = ESPAsync_WMtimeline.begin(F(name))
+#define WM_SPAN_END(id)             ESPAsync_WMtimeline.end(id)
+
+#else
+
+#define WM_SPAN(name)
+#define WM_SPAN_BEGIN(id, name)
+#define WM_SPAN_END(id)
+
+#endif    // USE_WM_TIMELINE
+
+////////////////////////////////////////////////////
+////////////////////////////////////////////////////
+
+// Counters, gauges and fixed-bucket histograms of the portal routes and of the WiFi connections,
+// served on /metrics in the Prometheus text format
+#ifndef USE_WM_METRICS
+  #define USE_WM_METRICS            false
+#endif
+
+// Portal routes, indexes of WM_METRICS_ROUTE_NAMES
+#define WM_ROUTE_ROOT               0
+#define WM_ROUTE_WIFI               1
+#define WM_ROUTE_WIFISAVE           2
+#define WM_ROUTE_CLOSE              3
+#define WM_ROUTE_INFO               4
+#define WM_ROUTE_RESET              5
+#define WM_ROUTE_STATE              6
+#define WM_ROUTE_SCAN               7
+#define WM_ROUTE_ASSET              8
+#define WM_ROUTE_TIMELINE           9
+#define WM_ROUTE_METRICS            10
+#define WM_ROUTE_LOG                11
+#define WM_ROUTE_PROBE              12
+#define WM_ROUTE_NOT_FOUND          13
+#define WM_ROUTE_COUNT              14
+
+#if USE_WM_METRICS
+
+#ifdef ESP32
+  // Updated from the AsyncTCP task as well as from loop()
+  typedef std::atomic<uint32_t>   WM_Counter;
+#else
+  // Single core, the async callbacks never preempt loop()
+  typedef uint32_t                WM_Counter;
+#endif
+
+#define WM_HISTOGRAM_MAX_BUCKETS    8
+
+// Connection results are counted by wl_status_t, up to WL_DISCONNECTED
+#define WM_METRICS_STATUS_COUNT     8
+
+class ESPAsync_WMHistogram
+{
+  public:
+
+    ESPAsync_WMHistogram();
+
+    // bounds : ascending upper bounds of the buckets, in 1 / scale s. The +Inf bucket is implicit
+    void          setBuckets(const uint32_t* bounds, const uint8_t& count, const uint32_t& scale);
+
+    void          observe(const uint32_t& value);
+
+    inline uint32_t count()
+    {
+      return _count;
+    }
+
+    // labels, if any, as 'route="/wifi"'
+    void          write(Print& out, const __FlashStringHelper* name, const char* labelName = NULL,
+                        const char* labelValue = NULL);
+
+  private:
+
+    const uint32_t* _bounds     = NULL;
+    uint8_t         _numBounds  = 0;
+    uint32_t        _scale      = 1;
+
+    WM_Counter      _buckets[WM_HISTOGRAM_MAX_BUCKETS + 1];
+    WM_Counter      _count;
+    WM_Counter      _sum;
+};
+
+class ESPAsync_WMMetrics
+{
+  public:
+
+    ESPAsync_WMMetrics();
+
+    // Handler time, in us, and response bytes of a portal route
+    void          request(const uint8_t& route, const uint32_t& us);
+    void          responseBytes(const uint8_t& route, const size_t& bytes);
+
+    void          scan(const uint32_t& ms, const int& networks);
+
+    // Result of a station connection attempt, time from WiFi.begin() to got IP / failure
+    void          connect(const wl_status_t& status, const uint32_t& ms);
+
+    // To be called by the sketch when reconnecting after losing the connection
+    void          reconnect();
+
+    // Prometheus text format, version 0.0.4
+    void          write(Print& out);
+
+  private:
+
+    ESPAsync_WMHistogram  _requestTime[WM_ROUTE_COUNT];
+    WM_Counter            _requestBytes[WM_ROUTE_COUNT];
+
+    ESPAsync_WMHistogram  _scanTime;
+    WM_Counter            _scanNetworks;
+
+    ESPAsync_WMHistogram  _connectTime;
+    WM_Counter            _connectResults[WM_METRICS_STATUS_COUNT];
+
+    WM_Counter            _reconnects;
+};
+
+extern ESPAsync_WMMetrics ESPAsync_WMmetrics;
+
+#endif    // USE_WM_METRICS
+
+////////////////////////////////////////////////////
+////////////////////////////////////////////////////
+
+// Admission control of the portal routes. Each response is charged its estimated heap use until its
+// connection closes. A request gets a small 503 page with Retry-After instead, when the responses in
+// flight would exceed WM_ADMISSION_BUDGET, or when the largest free heap block is smaller than its cost
+// plus WM_ADMISSION_HEAP_RESERVE
+#ifndef USE_WM_ADMISSION
+  #define USE_WM_ADMISSION          false
+#endif
+
+#if USE_WM_ADMISSION
+
+#ifndef WM_ADMISSION_BUDGET
+  #define WM_ADMISSION_BUDGET       8192
+#endif
+
+// Left to lwIP and the WiFi stack
+#ifndef WM_ADMISSION_HEAP_RESERVE
+  #define WM_ADMISSION_HEAP_RESERVE 4096
+#endif
+
+// In s
+#ifndef WM_ADMISSION_RETRY_AFTER
+  #define WM_ADMISSION_RETRY_AFTER  2
+#endif
+
+#define WM_ADMISSION_STR_(x)        #x
+#define WM_ADMISSION_STR(x)         WM_ADMISSION_STR_(x)
+
+const char WM_HTTP_RETRY_AFTER[]    = "Retry-After";
+
+// Sent from flash, reloads the page after WM_ADMISSION_RETRY_AFTER
+const char WM_HTTP_BUSY_PAGE[] PROGMEM = "<!DOCTYPE html><html><head><meta http-equiv='refresh' content='"
+                                         WM_ADMISSION_STR(WM_ADMISSION_RETRY_AFTER)
+                                         "'></head><body>Busy, retrying...</body></html>";
+
+class ESPAsync_WMAdmission
+{
+  public:
+
+    // cost : estimated heap used by the response until it's sent, in bytes
+    bool          admit(const uint32_t& cost);
+    void          release(const uint32_t& cost);
+
+    // Largest block malloc() can return now
+    static size_t largestFreeBlock();
+
+    inline uint32_t inFlight() const
+    {
+      return _inFlight;
+    }
+
+    inline uint32_t inFlightBytes() const
+    {
+      return _inFlightBytes;
+    }
+
+    inline uint32_t admitted() const
+    {
+      return _admitted;
+    }
+
+    // Over budget, and heap too low
+    inline uint32_t rejected() const
+    {
+      return _rejectedBudget + _rejectedHeap;
+    }
+
+    // Prometheus text format, appended to /metrics
+    void          write(Print& out);
+
+  private:
+
+    // Only updated from the web server callbacks, which all run in the AsyncTCP task on ESP32
+    uint32_t      _inFlight         = 0;
+    uint32_t      _inFlightBytes    = 0;
+    uint32_t      _admitted         = 0;
+    uint32_t      _rejectedBudget   = 0;
+    uint32_t      _rejectedHeap     = 0;
+};
+
+#endif    // USE_WM_ADMISSION
+
+////////////////////////////////////////////////////
+////////////////////////////////////////////////////
+
+// Table of known networks, kept in a crash-safe file (ESPAsync_WMConfigStore). connect() matches a scan
+// against it and only tries the known networks in range, best ranked first, instead of waiting for a
+// timeout on each absent one in turn
+#ifndef USE_WM_KNOWN_NETWORKS
+  #define USE_WM_KNOWN_NETWORKS     false
+#endif
+
+#if USE_WM_KNOWN_NETWORKS
+
+#include "ESPAsync_WMConfigStore.h"
+
+#ifndef WM_KNOWN_NETWORKS_SIZE
+  #define WM_KNOWN_NETWORKS_SIZE    24
+#endif
+
+// Bump when WM_KnownNetwork changes
+#define WM_KNOWN_NETWORKS_VERSION   1
+
+#define WM_KNOWN_SSID_LEN           33      // 32 + NUL
+#define WM_KNOWN_PASS_LEN           65      // 64 + NUL
+
+typedef struct
+{
+  char      ssid[WM_KNOWN_SSID_LEN];
+  char      pass[WM_KNOWN_PASS_LEN];
+  uint8_t   bssid[6];           // AP of the last connection
+  uint8_t   channel;
+  uint8_t   failures;           // Failed attempts since the last connection
+  uint16_t  successes;
+  uint32_t  lastConnected;      // Connection counter value, 0 if never connected. No RTC needed
+} WM_KnownNetwork;
+
+class ESPAsync_WMKnownNetworks
+{
+  public:
+
+    ESPAsync_WMKnownNetworks(fs::FS& fileSystem, const char* path);
+
+    bool          load();
+
+    // Only writes when the table changed
+    bool          save();
+
+    // Updates the password of a known SSID. Else adds it, replacing the worst ranked network if full
+    bool          add(const char* ssid, const char* pass);
+    bool          remove(const char* ssid);
+
+    // NULL if unknown
+    const char*   password(const char* ssid);
+
+    // Records a connection to the AP currently associated
+    void          connected();
+
+    // Scans, then tries the known networks found, best ranked first, timeout ms each.
+    // idle, if any, is called while waiting. Returns WL_NO_SSID_AVAIL if none is in range
+    wl_status_t   connect(const unsigned long& timeout, const std::function<void()>& idle = nullptr);
+
+    inline uint8_t count()
+    {
+      return _record.count;
+    }
+
+    inline const WM_KnownNetwork& network(const uint8_t& index)
+    {
+      return _record.networks[index];
+    }
+
+  private:
+
+    typedef struct
+    {
+      uint32_t          connections;    // Clock of lastConnected
+      uint8_t           count;
+      WM_KnownNetwork   networks[WM_KNOWN_NETWORKS_SIZE];
+    } Record;
+
+    // Known network in range
+    typedef struct
+    {
+      uint8_t           index;
+      int32_t           RSSI;           // Strongest AP of that SSID
+      uint8_t           bssid[6];
+      int32_t           channel;
+    } Candidate;
+
+    ESPAsync_WMConfigStore  _store;
+    Record                  _record;
+    bool                    _dirty    = false;
+
+    int           find(const char* ssid);
+
+    // Successes, halved by each failure since the last connection
+    inline uint16_t score(const WM_KnownNetwork& network)
+    {
+      return network.successes >> std::min(network.failures, (uint8_t) 15);
+    }
+
+    bool          isBetter(const WM_KnownNetwork& a, const WM_KnownNetwork& b);
+};
+
+#endif    // USE_WM_KNOWN_NETWORKS
+
+////////////////////////////////////////////////////
+////////////////////////////////////////////////////
+
+// Server-Sent Events on /events, small JSON messages :
+//  "status"  when the station wl_status_t changes, also while connecting
+//  "scan"    when new scan results are published
+//  "save"    with the result of connecting with the credentials just saved
+// The info and WiFi pages update in place instead of being fully re-rendered every 5s
+#ifndef USE_WM_EVENTS
+  #define USE_WM_EVENTS             false
+#endif
+
+#if USE_WM_EVENTS
+
+// Info page : shows the connection status, reloads once when the attempt is over.
+// Without EventSource, reloads every 5s like the meta refresh it replaces
+const char WM_HTTP_EVENTS_INFO_SCRIPT[] PROGMEM = "<script>if(window.EventSource){var es=new EventSource('/events');es.addEventListener('status',function(e){document.getElementById('st').innerHTML=JSON.parse(e.data).text;});es.addEventListener('save',function(){es.close();location.reload();});}else setTimeout(function(){location.reload();},5000);</script>";
+
+// WiFi page : redraws the network list from /scan after each scan
+const char WM_HTTP_EVENTS_WIFI_SCRIPT[] PROGMEM = "<script>if(window.EventSource&&window.fetch)new EventSource('/events').addEventListener('scan',function(){fetch('/scan').then(function(r){return r.json();}).then(function(j){var h='',t=document.createElement('a');j.Access_Points.forEach(function(a){t.textContent=a.SSID;h+=\"<div><a href='#p' onclick='c(this)'>\"+t.innerHTML+\"</a>&nbsp;<span class='q \"+(a.Encryption?'l':'')+\"'>\"+a.Quality+'%</span></div>';});document.getElementById('nl').innerHTML=h?'<fieldset>'+h+'</fieldset><br/>':'No network found.';});});</script>";
+
+#endif    // USE_WM_EVENTS
+
+////////////////////////////////////////////////////
+////////////////////////////////////////////////////
+
+// Render cache : /, /i and /state are built once, then served from the cached page until a WiFi event,
+// new scan results or saved credentials make them stale. With an ETag, so that pollers get a 304
+#ifndef USE_WM_RENDER_CACHE
+  #define USE_WM_RENDER_CACHE       false
+#endif
+
+#define WM_RENDER_ROOT              0
+#define WM_RENDER_INFO              1
+#define WM_RENDER_STATE             2
+#define WM_RENDER_COUNT             3
+
+// Not cached
+#define WM_RENDER_NONE              0xFF
+
+////////////////////////////////////////////////////
+////////////////////////////////////////////////////
+
+// Captive portal DNS responder (ESPAsync_WMCaptiveDNS) instead of AsyncDNSServer. A queries are answered
+// from a precomputed record, AAAA / HTTPS / SVCB ones at once with an empty reply. The AsyncDNSServer
+// passed to the constructor is then not used
+#ifndef USE_WM_CAPTIVE_DNS
+  #define USE_WM_CAPTIVE_DNS        false
+#endif
+
+#if USE_WM_CAPTIVE_DNS
+  #include "ESPAsync_WMCaptiveDNS.h"
+#endif
+
 ////////////////////////////////////////////////////
 ////////////////////////////////////////////////////
 
@@ -638,6 +1500,9 @@ class ESPAsync_WiFiManager
 #if USE_DYNAMIC_PARAMS
     //adds a custom parameter
     bool          addParameter(ESPAsync_WMParameter *p);
+
+    // Keeps the parameter table in the arena, instead of growing it with realloc()
+    void          setParamArena(ESPAsync_WMParamArena* arena);
 #else
     //adds a custom parameter
     void          addParameter(ESPAsync_WMParameter *p);
@@ -654,6 +1519,15 @@ class ESPAsync_WiFiManager
     //if this is true, remove duplicated Access Points - defaut true
     void          setRemoveDuplicateAPs(bool removeDuplicates);
 
+#if USE_WM_KNOWN_NETWORKS
+    // The credentials saved in the portal are added to it. Connecting through it with
+    // ESPAsync_WMKnownNetworks::connect() and saving it to flash are up to the sketch, out of the async handlers
+    inline void   setKnownNetworks(ESPAsync_WMKnownNetworks* knownNetworks)
+    {
+      _knownNetworks = knownNetworks;
+    }
+#endif
+
 ////////////////////////////////////////////////////
 
     // KH add to display SSIDs and PWDs in CP   
@@ -675,6 +1549,14 @@ class ESPAsync_WiFiManager
       _pass1  = pwd1;
     }
 
+////////////////////////////////////////////////////
+
+    // Current scan results, stable for as long as the returned pointer is held. May be empty
+    inline WiFiScanSnapshotPtr getScanSnapshot()
+    {
+      return std::atomic_load(&_scanSnapshot);
+    }
+
 ////////////////////////////////////////////////////
 
     // return SSID of router in STA mode got from config portal. NULL if no user's input //KH
@@ -748,6 +1630,13 @@ class ESPAsync_WiFiManager
 
     ///////////////////////////
      
+#if USE_WM_ADMISSION
+    inline const ESPAsync_WMAdmission& getAdmission()
+    {
+      return _admission;
+    }
+#endif
+
     inline const char* getCORSHeader()
     {
       return _CORS_Header;
@@ -849,20 +1738,36 @@ class ESPAsync_WiFiManager
     // .1 is the first occurrence of the day in the month
     // .0 is Sunday   
     
+    // Binary search in the PROGMEM index of utils/TZ_Index.h, one sorted table per enabled region.
+    // The result is copied to RAM, valid until the next call
     const char * getTZ(const char * timezoneName)
-    {               
-      //const char TZ_NAME[][TIMEZONE_MAX_LEN]
-      for (uint16_t index = 0; index < sizeof(TZ_NAME) / TIMEZONE_MAX_LEN; index++)
+    {
+      for (const WM_TZ_Region* region = WM_TZ_REGIONS; region->count > 0; region++)
       {
-        if ( !strncmp(timezoneName, (TZ_NAME[index]), strlen((TZ_NAME[index])) ) )
+        int low   = 0;
+        int high  = region->count - 1;
+
+        while (low <= high)
         {
-          yield();
-          
-          return (ESP_TZ_NAME[index]);            
-        }    
+          int middle  = (low + high) / 2;
+          int result  = strcmp_P(timezoneName, region->names + pgm_read_word(&region->index[middle][0]));
+
+          if (result == 0)
+          {
+            strncpy_P(_TZ, region->values + pgm_read_word(&region->index[middle][1]), sizeof(_TZ) - 1);
+            _TZ[sizeof(_TZ) - 1] = 0;
+
+            return _TZ;
+          }
+
+          if (result < 0)
+            high = middle - 1;
+          else
+            low = middle + 1;
+        }
       }
-      
-      return "";      
+
+      return "";
     }
 
     ///////////////////////////
@@ -880,6 +1785,10 @@ class ESPAsync_WiFiManager
   
     AsyncDNSServer      *dnsServer;
 
+#if USE_WM_CAPTIVE_DNS
+    ESPAsync_WMCaptiveDNS _captiveDNS;
+#endif
+
     AsyncWebServer *server;
 
     bool            _modeless;
@@ -906,11 +1815,36 @@ class ESPAsync_WiFiManager
     String        _ssid1                = "";
     String        _pass1                = "";
 
+#if USE_WM_KNOWN_NETWORKS
+    ESPAsync_WMKnownNetworks* _knownNetworks  = NULL;
+#endif
+
+#if USE_WM_EVENTS
+    // Owned by server, deleted by server->reset()
+    AsyncEventSource*         _events         = NULL;
+
+    // Last status sent, -1 to send it again
+    volatile int              _eventStatus    = -1;
+
+    inline bool   hasEventClients()
+    {
+      return (_events && (_events->count() > 0));
+    }
+
+    void          sendEvent(const char* event, const String& data);
+    void          sendStatusEvent();
+    void          sendScanEvent(const wifi_ssid_count_t& count);
+    void          sendSaveEvent(const int& status);
+#endif
+
     ////////////////////////////////////////////////////
 
 #if USE_ESP_WIFIMANAGER_NTP
     // Timezone info
     String        _timezoneName         = "";
+
+    // getTZ() result
+    char          _TZ[WM_TZ_VALUE_MAX_LEN + 1];
 #endif
 
     ////////////////////////////////////////////////////
@@ -923,10 +1857,25 @@ class ESPAsync_WiFiManager
     int                 numberOfNetworks;
     int                 *networkIndices;
     
-    WiFiResult          *wifiSSIDs;
-    wifi_ssid_count_t   wifiSSIDCount;
-    bool                wifiSSIDscan;
-    
+    // Published with std::atomic_store(), read with getScanSnapshot().
+    // _spareScanSnapshot is the previous one, recycled for the next scan once no handler holds it.
+    WiFiScanSnapshotPtr _scanSnapshot;
+    WiFiScanSnapshotPtr _spareScanSnapshot;
+
+    // Merged results of the recent scans, the snapshots are copies of it. Allocated by the first scan
+    WiFiScanCache       *_scanCache         = NULL;
+
+    // Non-blocking scan state machine
+    bool                _asyncScanRunning   = false;
+    unsigned long       _asyncScanStart     = 0;
+
+    void                startAsyncScan();
+    void                pollAsyncScan();
+    void                processScanResults(const wifi_ssid_count_t& n);
+    void                mergeScanResults(const wifi_ssid_count_t& n);
+    void                markDuplicateAPs(WiFiResult *results, const wifi_ssid_count_t& n);
+    const WiFiResult*   findScannedAP(const WiFiScanSnapshotPtr& snapshot, const String& ssid);
+
     // To enable dynamic/random channel
     // default to channel 1
     #define MIN_WIFI_CHANNEL      1
@@ -961,20 +1910,165 @@ class ESPAsync_WiFiManager
     int           connectWifi(const String& ssid = "", const String& pass = "");
     
     wl_status_t   waitForConnectResult();
+
+    ESPAsync_WMConnectWaiter  _connectWaiter;
     
     void          setInfo();
     String        networkListAsString();
+    // Static, run from the /wifi response, which may still be sent after the manager is gone
+    static bool   networkItemAsString(String& item, const WiFiResult& result, const int& minimumQuality);
+    void          paramAsString(String& item, ESPAsync_WMParameter* param);
+    void          staticIPFieldAsString(String& item, const char* id, const char* placeholder, const IPAddress& ip);
+
+    // Compiled on first use. Form templates all take the same "i,n,p,l,v,c" values
+    static ESPAsync_WMTemplate _networkItemTemplate;
+    ESPAsync_WMTemplate _labelBeforeTemplate      { WM_HTTP_FORM_LABEL_BEFORE,  "i,n,p,l,v,c" };
+    ESPAsync_WMTemplate _labelAfterTemplate       { WM_HTTP_FORM_LABEL_AFTER,   "i,n,p,l,v,c" };
+    ESPAsync_WMTemplate _labelTemplate            { WM_HTTP_FORM_LABEL,         "i,n,p,l,v,c" };
+    ESPAsync_WMTemplate _paramTemplate            { WM_HTTP_FORM_PARAM,         "i,n,p,l,v,c" };
+    ESPAsync_WMTemplate _headStartTemplate        { WM_HTTP_HEAD_START,         "v" };
+    ESPAsync_WMTemplate _savedTemplate            { WM_HTTP_SAVED,              "v,x,x1" };
+#if DISPLAY_STORED_CREDENTIALS_IN_CP
+    ESPAsync_WMTemplate _formStartTemplate        { WM_HTTP_FORM_START,         "ssid,pwd,ssid1,pwd1" };
+#endif
+
+    void          streamHead(ESPAsync_WMPageStream& stream, const char* title, const bool& withNTP = false);
+
+#if USE_WM_GZIP_ASSETS
+    void          handleAsset(AsyncWebServerRequest *request, const uint8_t* data, const size_t& length,
+                              const char* contentType, const char* etag);
+#endif
+    // cacheSlot : WM_RENDER_*, to keep the page in the render cache and serve it from there
+    void          sendStream(AsyncWebServerRequest *request, const ESPAsync_WMPageStreamPtr& stream,
+                             const char* contentType = WM_HTTP_HEAD_CT, const uint8_t& cacheSlot = WM_RENDER_NONE);
+
+#if USE_WM_RENDER_CACHE
+    typedef struct
+    {
+      ESPAsync_WMPageStreamPtr  stream;         // Static, only read at an offset by the responses
+      size_t                    length;
+      uint32_t                  version;        // _renderVersion it was built for
+      char                      etag[11];       // Quoted FNV-1a of the content
+    } RenderedPage;
+
+    RenderedPage          _rendered[WM_RENDER_COUNT];
+
+    // Bumped by WiFi events, new scan results and saved credentials. Pages of another version are stale
+    volatile uint32_t     _renderVersion    = 1;
+
+    // Read before building a page, so that an event while building leaves it stale
+    uint32_t              _renderingVersion = 0;
+
+#ifdef ESP8266
+    WiFiEventHandler      _renderGotIPHandler;
+    WiFiEventHandler      _renderDisconnectedHandler;
+#else
+    wifi_event_id_t       _renderEventID    = 0;
+#endif
+
+    inline void   invalidateRendered()
+    {
+      _renderVersion++;
+    }
+
+    void          subscribeRendered();
+    void          unsubscribeRendered();
+    bool          sendRendered(AsyncWebServerRequest *request, const uint8_t& slot,
+                               const char* contentType = WM_HTTP_HEAD_CT);
+    bool          keepRendered(const uint8_t& slot, const ESPAsync_WMPageStreamPtr& stream);
+#endif
     
     void          handleRoot(AsyncWebServerRequest *request);
     void          handleWifi(AsyncWebServerRequest *request);
     void          handleWifiSave(AsyncWebServerRequest *request);
+
+    // /wifisave form fields, bound to where their value goes. Looked up by name hash,
+    // so that the form is decoded in a single pass over the request arguments
+    typedef struct
+    {
+      const char    *name;
+      uint32_t      hash;
+      uint8_t       type;         // WM_FORM_*
+      void          *target;
+      int           length;       // WM_FORM_VALUE : the value is truncated to length - 1
+    } FormField;
+
+    #define WM_FORM_STRING        0     // String
+    #define WM_FORM_VALUE         1     // char[], a parameter value
+    #define WM_FORM_IP            2     // IPAddress
+
+    std::vector<FormField>  _formFields;
+    std::vector<uint16_t>   _formSlots;                 // Power of 2 sized, index in _formFields + 1, 0 if empty
+    bool                    _formFieldsValid  = false;  // Rebuilt after the parameters changed
+
+    void          addFormField(const char* name, const uint8_t& type, void* target, const int& length = 0);
+    void          buildFormFields();
+    void          decodeForm(AsyncWebServerRequest *request);
+
+    static inline uint32_t hashName(const char* name)
+    {
+      // FNV-1a
+      uint32_t hash = 2166136261UL;
+
+      for (const char *p = name; *p; p++)
+      {
+        hash = (hash ^ (uint8_t) *p) * 16777619UL;
+      }
+
+      return hash;
+    }
+
     void          handleServerClose(AsyncWebServerRequest *request);
     void          handleInfo(AsyncWebServerRequest *request);
     void          handleState(AsyncWebServerRequest *request);
     void          handleScan(AsyncWebServerRequest *request);
     void          handleReset(AsyncWebServerRequest *request);
     void          handleNotFound(AsyncWebServerRequest *request);
+
+#if USE_WM_TIMELINE
+    void          handleTimeline(AsyncWebServerRequest *request);
+#endif
+
+#if USE_WM_METRICS
+    void          handleMetrics(AsyncWebServerRequest *request);
+#endif
+
+#if ( USE_WM_DEFERRED_LOG && USE_WM_LOG_ROUTE )
+    void          handleLog(AsyncWebServerRequest *request);
+#endif
+
+    // Route of the handler being run, to count its response bytes
+    uint8_t       _metricsRoute     = 0;
+
+    typedef void (ESPAsync_WiFiManager::*RequestHandler)(AsyncWebServerRequest *request);
+
+    // Admits the request (USE_WM_ADMISSION) and times handler into the route's histogram (USE_WM_METRICS).
+    // Just the handler if both are false
+    ArRequestHandlerFunction  measured(const uint8_t& route, const ArRequestHandlerFunction& handler);
+    ArRequestHandlerFunction  measured(const uint8_t& route, RequestHandler handler);
+
+    static inline void countBytes(const uint8_t& route, const size_t& bytes)
+    {
+#if USE_WM_METRICS
+      ESPAsync_WMmetrics.responseBytes(route, bytes);
+#else
+      (void) route;
+      (void) bytes;
+#endif
+    }
     bool          captivePortal(AsyncWebServerRequest *request);   
+
+#if USE_WM_ADMISSION
+    ESPAsync_WMAdmission  _admission;
+
+    // Charges the request's route until its connection closes, or answers 503. Returns false in that case
+    bool          admit(AsyncWebServerRequest *request, const uint8_t& route);
+#endif
+
+    // "http://" + AP IP, built by setupConfigPortal()
+    char          _portalLocation[24]   = "";
+
+    void          handleProbe(AsyncWebServerRequest *request);
     
     void          reportStatus(String& page);
 
@@ -982,7 +2076,7 @@ class ESPAsync_WiFiManager
     const byte    DNS_PORT = 53;
 
     //helpers
-    int           getRSSIasQuality(const int& RSSI);
+    static int    getRSSIasQuality(const int& RSSI);
     bool          isIp(const String& str);
     String        toStringIp(const IPAddress& ip);
 
@@ -999,6 +2093,7 @@ class ESPAsync_WiFiManager
 #if USE_DYNAMIC_PARAMS
     int                     _max_params;
     ESPAsync_WMParameter**  _params;
+    bool                    _paramsInArena  = false;    // Table owned by an ESPAsync_WMParamArena
 #else
     ESPAsync_WMParameter*   _params[WIFI_MANAGER_MAX_PARAMS];
 #endif
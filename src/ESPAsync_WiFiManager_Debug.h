@@ -57,6 +57,62 @@
 
 /////////////////////////////////////////////////////////
 
+// Use true to have the LOG* macros only append a binary record to a RAM ring, formatted and printed later
+// by ESPAsync_WMlog.drain() from loop(), instead of blocking on the UART. See ESPAsync_WMLog.h
+#ifndef USE_WM_DEFERRED_LOG
+  #define USE_WM_DEFERRED_LOG       false
+#endif
+
+// Use true to also serve the records still in that ring on /log. Any client of the portal AP can read them,
+// without authentication, so it's a separate opt-in. Needs USE_WM_DEFERRED_LOG
+#ifndef USE_WM_LOG_ROUTE
+  #define USE_WM_LOG_ROUTE          false
+#endif
+
+/////////////////////////////////////////////////////////
+
+#if USE_WM_DEFERRED_LOG
+
+#include "ESPAsync_WMLog.h"
+
+#define ESP_WM_LOG(level, marked, ...)  if(_ESPASYNC_WIFIMGR_LOGLEVEL_>=level) { ESPAsync_WMlog.log(level, marked, __VA_ARGS__); }
+
+/////////////////////////////////////////////////////////
+
+#define LOGERROR(x)         ESP_WM_LOG(1, true,  x)
+#define LOGERROR0(x)        ESP_WM_LOG(1, false, x)
+#define LOGERROR1(x,y)      ESP_WM_LOG(1, true,  x, y)
+#define LOGERROR2(x,y,z)    ESP_WM_LOG(1, true,  x, y, z)
+#define LOGERROR3(x,y,z,w)  ESP_WM_LOG(1, true,  x, y, z, w)
+
+/////////////////////////////////////////////////////////
+
+#define LOGWARN(x)          ESP_WM_LOG(2, true,  x)
+#define LOGWARN0(x)         ESP_WM_LOG(2, false, x)
+#define LOGWARN1(x,y)       ESP_WM_LOG(2, true,  x, y)
+#define LOGWARN2(x,y,z)     ESP_WM_LOG(2, true,  x, y, z)
+#define LOGWARN3(x,y,z,w)   ESP_WM_LOG(2, true,  x, y, z, w)
+
+/////////////////////////////////////////////////////////
+
+#define LOGINFO(x)          ESP_WM_LOG(3, true,  x)
+#define LOGINFO0(x)         ESP_WM_LOG(3, false, x)
+#define LOGINFO1(x,y)       ESP_WM_LOG(3, true,  x, y)
+#define LOGINFO2(x,y,z)     ESP_WM_LOG(3, true,  x, y, z)
+#define LOGINFO3(x,y,z,w)   ESP_WM_LOG(3, true,  x, y, z, w)
+
+/////////////////////////////////////////////////////////
+
+#define LOGDEBUG(x)         ESP_WM_LOG(4, true,  x)
+#define LOGDEBUG0(x)        ESP_WM_LOG(4, false, x)
+#define LOGDEBUG1(x,y)      ESP_WM_LOG(4, true,  x, y)
+#define LOGDEBUG2(x,y,z)    ESP_WM_LOG(4, true,  x, y, z)
+#define LOGDEBUG3(x,y,z,w)  ESP_WM_LOG(4, true,  x, y, z, w)
+
+/////////////////////////////////////////////////////////
+
+#else    // USE_WM_DEFERRED_LOG
+
 const char ESP_WM_MARK[] = "[WM] ";
 const char ESP_WM_SP[]   = " ";
 
@@ -100,5 +156,9 @@ const char ESP_WM_SP[]   = " ";
 
 /////////////////////////////////////////////////////////
 
+#endif    // USE_WM_DEFERRED_LOG
+
+/////////////////////////////////////////////////////////
+
 #endif    // ESPAsync_WiFiManager_Debug_H
 
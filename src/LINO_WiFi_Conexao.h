@@ -60,10 +60,6 @@
 #include <WiFiClient.h>
 #include <esp_wifi.h>
 
-// From v1.1.1
-#include <WiFiMulti.h>
-WiFiMulti wifiMulti;
-
 // LittleFS has higher priority than SPIFFS
 #if (defined(ESP_ARDUINO_VERSION_MAJOR) && (ESP_ARDUINO_VERSION_MAJOR >= 2))
 #define USE_LITTLEFS true
@@ -128,10 +124,6 @@ FS *filesystem = &FFat;
 // needed for library
 #include <ESPAsyncDNSServer.h>
 
-// From v1.1.1
-#include <ESP8266WiFiMulti.h>
-ESP8266WiFiMulti wifiMulti;
-
 #define USE_LITTLEFS true
 
 #if USE_LITTLEFS
@@ -255,6 +247,30 @@ WM_Config WM_config;
 #define CONFIG_FILENAME F("/wifi_cred.dat")
 //////
 
+// Fast reconnect: BSSID and channel of the last good connection, kept next to WM_Config.
+// On boot they're passed to WiFi.begin(), which skips the channel scan. The address still comes from
+// DHCP, so that the lease is held and renewed. The known networks scan is only used if that fails.
+#define USE_WIFI_FAST_CONNECT true
+
+#define FAST_CONNECT_FILENAME F("/wifi_fast.dat")
+
+// Time allowed to the fast path to join the saved AP, before falling back to the full scan
+#define FAST_CONNECT_TIMEOUT_MS 1500L
+
+// Then, once joined, time allowed to DHCP. The saved AP is fine even if this runs out
+#define FAST_CONNECT_DHCP_TIMEOUT_MS 5000L
+
+typedef struct
+{
+    char wifi_ssid[SSID_MAX_LEN];
+    uint8_t bssid[6];
+    int32_t channel;
+    uint16_t checksum;
+} WiFi_FastConnect;
+
+WiFi_FastConnect WM_fastConnect;
+//////
+
 // Indicates whether ESP has WiFi credentials saved from previous session, or double reset detected
 bool initialConfig = false;
 
@@ -292,6 +308,36 @@ bool initialConfig = false;
 // New in v1.0.11
 #define USING_CORS_FEATURE true
 
+// Records the boot phases with micros() timestamps, printed at the end of conectarWiFi() and served on /timeline
+#define USE_WM_TIMELINE true
+
+// Portal route latencies, scans, connection attempts and heap, in Prometheus format on /metrics
+#define USE_WM_METRICS true
+
+// LOG* macros only queue binary records in RAM, printed later from check_status().
+// Not served on /log : USE_WM_LOG_ROUTE is left off, the portal AP is open to anyone in range
+#define USE_WM_DEFERRED_LOG true
+
+// Portal pages updated through Server-Sent Events on /events, instead of reloading every 5s while connecting
+#define USE_WM_EVENTS true
+
+// Answers 503 instead of rendering more portal pages at once than the heap can take
+#define USE_WM_ADMISSION true
+
+// /, /i and /state built once and served from RAM with an ETag until WiFi, a scan or a save changes them
+#define USE_WM_RENDER_CACHE true
+
+// Known networks table instead of the two credentials of WM_Config : connectMultiWiFi() scans and
+// only tries the known networks in range, the ones connected most often first
+#define USE_WM_KNOWN_NETWORKS true
+
+#define WM_KNOWN_NETWORKS_SIZE 24
+
+#define KNOWN_NETWORKS_FILENAME "/wifi_known.ab"
+
+// Time allowed to each known network in range
+#define KNOWN_NETWORK_CONNECT_TIMEOUT_MS 10000L
+
 ////////////////////////////////////////////
 
 // Use USE_DHCP_IP == true for dynamic DHCP IP, false to use static IP which you have to change accordingly to your network
@@ -349,6 +395,7 @@ IPAddress APStaticGW = IPAddress(192, 168, 100, 1);
 IPAddress APStaticSN = IPAddress(255, 255, 255, 0);
 
 #include <ESPAsync_WiFiManager.h>  //https://github.com/khoih-prog/ESPAsync_WiFiManager
+#include <ESPAsync_WMConfigStore.h>
 
 // Redundant, for v1.10.0 only
 // #include <ESPAsync_WiFiManager-Impl.h>          //https://github.com/khoih-prog/ESPAsync_WiFiManager
@@ -368,6 +415,24 @@ String Router_Pass;
 
 AsyncWebServer webServer(HTTP_PORT);
 
+ESPAsync_WMKnownNetworks knownNetworks(FileFS, KNOWN_NETWORKS_FILENAME);
+
+// The credentials of WM_Config, last entered in the portal, and the ones stored by the ESP
+void addKnownNetworks() {
+    if ((Router_SSID != "") && (Router_Pass != ""))
+        knownNetworks.add(Router_SSID.c_str(), Router_Pass.c_str());
+
+    for (uint8_t i = 0; i < NUM_WIFI_CREDENTIALS; i++) {
+        // Don't permit NULL SSID and password len < MIN_AP_PASSWORD_SIZE (8)
+        if ((String(WM_config.WiFi_Creds[i].wifi_ssid) != "") && (strlen(WM_config.WiFi_Creds[i].wifi_pw) >= MIN_AP_PASSWORD_SIZE)) {
+            LOGERROR3(F("* Add SSID = "), WM_config.WiFi_Creds[i].wifi_ssid, F(", PW = "), F("***"));
+            knownNetworks.add(WM_config.WiFi_Creds[i].wifi_ssid, WM_config.WiFi_Creds[i].wifi_pw);
+        }
+    }
+
+    knownNetworks.save();
+}
+
 ///////////////////////////////////////////
 // New in v1.4.0
 /******************************************
@@ -431,45 +496,152 @@ void configWiFi(WiFi_STA_IPConfig in_WM_STA_IPconfig) {
 
 ///////////////////////////////////////////
 
-uint8_t connectMultiWiFi() {
-#if ESP32
-    // For ESP32, this better be 0 to shorten the connect time.
-    // For ESP32-S2/C3, must be > 500
-#if (USING_ESP32_S2 || USING_ESP32_C3)
-#define WIFI_MULTI_1ST_CONNECT_WAITING_MS 500L
-#else
-    // For ESP32 core v1.0.6, must be >= 500
-#define WIFI_MULTI_1ST_CONNECT_WAITING_MS 800L
-#endif
-#else
-    // For ESP8266, this better be 2200 to enable connect the 1st time
-#define WIFI_MULTI_1ST_CONNECT_WAITING_MS 2200L
+#if USE_WIFI_FAST_CONNECT
+
+int calcChecksum(uint8_t *address, uint16_t sizeToCalc);
+
+bool fastConnectLoaded = false;
+
+bool loadFastConnectData() {
+    File file = FileFS.open(FAST_CONNECT_FILENAME, "r");
+
+    memset((void *)&WM_fastConnect, 0, sizeof(WM_fastConnect));
+
+    if (!file)
+        return false;
+
+    size_t len = file.readBytes((char *)&WM_fastConnect, sizeof(WM_fastConnect));
+    file.close();
+
+    if ((len != sizeof(WM_fastConnect)) ||
+        (WM_fastConnect.checksum != calcChecksum((uint8_t *)&WM_fastConnect, sizeof(WM_fastConnect) - sizeof(WM_fastConnect.checksum)))) {
+        LOGERROR(F("WM_fastConnect checksum wrong"));
+        memset((void *)&WM_fastConnect, 0, sizeof(WM_fastConnect));
+
+        return false;
+    }
+
+    return true;
+}
+
+// Called once connected. Only written when the AP changed, to spare the flash
+void saveFastConnectData() {
+    WiFi_FastConnect current;
+
+    memset((void *)&current, 0, sizeof(current));
+
+    strncpy(current.wifi_ssid, WiFi.SSID().c_str(), sizeof(current.wifi_ssid) - 1);
+    memcpy(current.bssid, WiFi.BSSID(), sizeof(current.bssid));
+    current.channel = WiFi.channel();
+    current.checksum = calcChecksum((uint8_t *)&current, sizeof(current) - sizeof(current.checksum));
+
+    if (fastConnectLoaded && (memcmp(&current, &WM_fastConnect, sizeof(current)) == 0))
+        return;
+
+    File file = FileFS.open(FAST_CONNECT_FILENAME, "w");
+
+    if (file) {
+        file.write((uint8_t *)&current, sizeof(current));
+        file.close();
+
+        WM_fastConnect = current;
+        fastConnectLoaded = true;
+
+        LOGERROR3(F("Saved fast connect data, channel ="), current.channel, F(", IP ="), WiFi.localIP());
+    }
+}
+
+void clearFastConnectData() {
+    memset((void *)&WM_fastConnect, 0, sizeof(WM_fastConnect));
+    FileFS.remove(String(FAST_CONNECT_FILENAME));
+}
+
+bool fastConnectWiFi() {
+    WM_SPAN("fastConnectWiFi");
+
+    if (!fastConnectLoaded)
+        fastConnectLoaded = loadFastConnectData();
+
+    if (!fastConnectLoaded || (WM_fastConnect.channel <= 0))
+        return false;
+
+    const char *pass = knownNetworks.password(WM_fastConnect.wifi_ssid);
+
+    if (!pass) {
+        // Credentials changed since
+        clearFastConnectData();
+        fastConnectLoaded = false;
+
+        return false;
+    }
+
+    unsigned long startedAt = millis();
+
+    LOGERROR3(F("Fast connect to "), WM_fastConnect.wifi_ssid, F(", channel ="), WM_fastConnect.channel);
+
+    WiFi.mode(WIFI_STA);
+
+#if !USE_DHCP_IP
+    configWiFi(WM_STA_IPconfig);
 #endif
 
-#define WIFI_MULTI_CONNECT_WAITING_MS 500L
+    WiFi.begin(WM_fastConnect.wifi_ssid, pass, WM_fastConnect.channel, WM_fastConnect.bssid);
 
-    uint8_t status;
+    ESPAsync_WMConnectWaiter connectWaiter;
 
-    // WiFi.mode(WIFI_STA);
+    connectWaiter.begin(FAST_CONNECT_TIMEOUT_MS);
 
-    LOGERROR(F("ConnectMultiWiFi with :"));
+    wl_status_t status = connectWaiter.wait();
+    bool joined = connectWaiter.joined();
 
-    if ((Router_SSID != "") && (Router_Pass != "")) {
-        LOGERROR3(F("* Flash-stored Router_SSID = "), Router_SSID, F(", Router_Pass = "), Router_Pass);
-        LOGERROR3(F("* Add SSID = "), Router_SSID, F(", PW = "), Router_Pass);
-        wifiMulti.addAP(Router_SSID.c_str(), Router_Pass.c_str());
+    if ((status != WL_CONNECTED) && joined) {
+        // Joined in time, only DHCP is still running
+        LOGERROR1(F("Fast connect joined, waiting for DHCP after ms: "), millis() - startedAt);
+
+        connectWaiter.begin(FAST_CONNECT_DHCP_TIMEOUT_MS);
+        status = connectWaiter.wait();
     }
 
-    for (uint8_t i = 0; i < NUM_WIFI_CREDENTIALS; i++) {
-        // Don't permit NULL SSID and password len < MIN_AP_PASSWORD_SIZE (8)
-        if ((String(WM_config.WiFi_Creds[i].wifi_ssid) != "") && (strlen(WM_config.WiFi_Creds[i].wifi_pw) >= MIN_AP_PASSWORD_SIZE)) {
-            LOGERROR3(F("* Additional SSID = "), WM_config.WiFi_Creds[i].wifi_ssid, F(", PW = "), WM_config.WiFi_Creds[i].wifi_pw);
-        }
+    if (status == WL_CONNECTED) {
+        LOGERROR1(F("Fast connect OK after ms: "), millis() - startedAt);
+
+        knownNetworks.connected();
+        knownNetworks.save();
+
+        return true;
     }
 
-    LOGERROR(F("Connecting MultiWifi..."));
+    LOGERROR(F("Fast connect failed, falling back to full connect"));
 
-    // WiFi.mode(WIFI_STA);
+    WiFi.disconnect();
+
+    if (!joined) {
+        // Don't try a stale AP again, the full connect saves the new one.
+        // Kept after a DHCP timeout, the AP itself was right
+        clearFastConnectData();
+        fastConnectLoaded = false;
+    }
+
+    return false;
+}
+
+#endif
+
+///////////////////////////////////////////
+
+uint8_t connectMultiWiFi() {
+    WM_SPAN("connectMultiWiFi");
+
+    uint8_t status;
+
+#if USE_WIFI_FAST_CONNECT
+    if (fastConnectWiFi())
+        return WL_CONNECTED;
+#endif
+
+    WiFi.mode(WIFI_STA);
+
+    LOGERROR1(F("ConnectMultiWiFi, known networks = "), knownNetworks.count());
 
 #if !USE_DHCP_IP
     // New in v1.4.0
@@ -477,24 +649,25 @@ uint8_t connectMultiWiFi() {
     //////
 #endif
 
-    int i = 0;
-
-    status = wifiMulti.run();
-    delay(WIFI_MULTI_1ST_CONNECT_WAITING_MS);
+    unsigned long startedAt = millis();
 
-    while ((i++ < 20) && (status != WL_CONNECTED)) {
-        status = WiFi.status();
+    // Only the known networks found by the scan are tried, the most successful first.
+    // Keep the DRD alive while waiting
+    status = knownNetworks.connect(KNOWN_NETWORK_CONNECT_TIMEOUT_MS, []() {
+        drd->loop();
+    });
 
-        if (status == WL_CONNECTED)
-            break;
-        else
-            delay(WIFI_MULTI_CONNECT_WAITING_MS);
-    }
+    // Success and failure counts
+    knownNetworks.save();
 
     if (status == WL_CONNECTED) {
-        LOGERROR1(F("WiFi connected after time: "), i);
+        LOGERROR1(F("WiFi connected after ms: "), millis() - startedAt);
         LOGERROR3(F("SSID:"), WiFi.SSID(), F(",RSSI="), WiFi.RSSI());
         LOGERROR3(F("Channel:"), WiFi.channel(), F(",IP address:"), WiFi.localIP());
+
+#if USE_WIFI_FAST_CONNECT
+        saveFastConnectData();
+#endif
     } else {
         LOGERROR(F("WiFi not connected"));
 
@@ -565,6 +738,11 @@ void heartBeatPrint() {
 void check_WiFi() {
     if ((WiFi.status() != WL_CONNECTED)) {
         Serial.println(F("\nWiFi lost. Call connectMultiWiFi in loop"));
+
+#if USE_WM_METRICS
+        ESPAsync_WMmetrics.reconnect();
+#endif
+
         connectMultiWiFi();
     }
 }
@@ -585,6 +763,11 @@ void check_status() {
 
     current_millis = millis();
 
+#if USE_WM_DEFERRED_LOG
+    // Without blocking on a full UART TX buffer
+    ESPAsync_WMlog.drain(Serial);
+#endif
+
     // Check WiFi every WIFICHECK_INTERVAL (1) seconds.
     if ((current_millis > checkwifi_timeout) || (checkwifi_timeout == 0)) {
         check_WiFi();
@@ -608,7 +791,8 @@ int calcChecksum(uint8_t *address, uint16_t sizeToCalc) {
     return checkSum;
 }
 
-bool loadConfigData() {
+// Raw WM_Config + WiFi_STA_IPConfig dump of the former /wifi_cred.dat, only read to migrate it
+bool loadLegacyConfigData() {
     File file = FileFS.open(CONFIG_FILENAME, "r");
     LOGERROR(F("LoadWiFiCfgFile "));
 
@@ -646,30 +830,115 @@ bool loadConfigData() {
     }
 }
 
-void saveConfigData() {
-    File file = FileFS.open(CONFIG_FILENAME, "w");
-    LOGERROR(F("SaveWiFiCfgFile "));
+// WM_Config and WiFi_STA_IPConfig, saved in the A/B config store. IPs as plain IPv4 values,
+// as IPAddress isn't a plain struct on all cores
+// Bump CONFIG_STORE_VERSION when the record changes, and convert the older versions in loadConfigData()
+#define CONFIG_STORE_VERSION 1
+#define CONFIG_STORE_FILENAME "/wifi_cfg.ab"
 
-    if (file) {
-        WM_config.checksum = calcChecksum((uint8_t *)&WM_config, sizeof(WM_config) - sizeof(WM_config.checksum));
+typedef struct
+{
+    WM_Config config;
+    uint32_t sta_static_ip;
+    uint32_t sta_static_gw;
+    uint32_t sta_static_sn;
+    uint32_t sta_static_dns1;
+    uint32_t sta_static_dns2;
+} WM_ConfigRecord;
 
-        file.write((uint8_t *)&WM_config, sizeof(WM_config));
+ESPAsync_WMConfigStore configStore(FileFS, CONFIG_STORE_FILENAME, sizeof(WM_ConfigRecord));
 
-        displayIPConfigStruct(WM_STA_IPconfig);
+bool saveConfigData();
 
-        // New in v1.4.0
-        file.write((uint8_t *)&WM_STA_IPconfig, sizeof(WM_STA_IPconfig));
-        //////
+bool loadConfigData() {
+    WM_SPAN("loadConfigData");
+
+    LOGERROR(F("LoadWiFiCfgStore "));
+
+    WM_ConfigRecord record;
+    uint16_t version = 0;
+
+    memset((void *)&record, 0, sizeof(record));
+    memset((void *)&WM_config, 0, sizeof(WM_config));
+    WM_STA_IPconfig = WiFi_STA_IPConfig();
+
+    if (configStore.load(&record, sizeof(record), version) == 0) {
+        // Not migrated yet
+        if (loadLegacyConfigData()) {
+            LOGERROR(F("Migrating legacy config file"));
+
+            // Keep the legacy file, the only copy, until the store has it
+            if (saveConfigData())
+                FileFS.remove(String(CONFIG_FILENAME));
+
+            return true;
+        }
 
-        file.close();
-        LOGERROR(F("OK"));
-    } else {
         LOGERROR(F("failed"));
+
+        return false;
     }
+
+    if (version != CONFIG_STORE_VERSION) {
+        LOGERROR1(F("Unknown config version ="), version);
+
+        return false;
+    }
+
+    WM_config = record.config;
+
+    WM_STA_IPconfig._sta_static_ip = IPAddress(record.sta_static_ip);
+    WM_STA_IPconfig._sta_static_gw = IPAddress(record.sta_static_gw);
+    WM_STA_IPconfig._sta_static_sn = IPAddress(record.sta_static_sn);
+#if USE_CONFIGURABLE_DNS
+    WM_STA_IPconfig._sta_static_dns1 = IPAddress(record.sta_static_dns1);
+    WM_STA_IPconfig._sta_static_dns2 = IPAddress(record.sta_static_dns2);
+#endif
+
+    LOGERROR(F("OK"));
+
+    displayIPConfigStruct(WM_STA_IPconfig);
+
+    return true;
+}
+
+// Only the older of the two slots is rewritten, a power cut at any time keeps the last good config
+bool saveConfigData() {
+    LOGERROR(F("SaveWiFiCfgStore "));
+
+    WM_ConfigRecord record;
+
+    memset((void *)&record, 0, sizeof(record));
+
+    // Not needed by the store, kept so that the WM_Config layout doesn't change
+    WM_config.checksum = calcChecksum((uint8_t *)&WM_config, sizeof(WM_config) - sizeof(WM_config.checksum));
+
+    record.config = WM_config;
+    record.sta_static_ip = (uint32_t)WM_STA_IPconfig._sta_static_ip;
+    record.sta_static_gw = (uint32_t)WM_STA_IPconfig._sta_static_gw;
+    record.sta_static_sn = (uint32_t)WM_STA_IPconfig._sta_static_sn;
+#if USE_CONFIGURABLE_DNS
+    record.sta_static_dns1 = (uint32_t)WM_STA_IPconfig._sta_static_dns1;
+    record.sta_static_dns2 = (uint32_t)WM_STA_IPconfig._sta_static_dns2;
+#endif
+
+    displayIPConfigStruct(WM_STA_IPconfig);
+
+    if (configStore.save(&record, sizeof(record), CONFIG_STORE_VERSION)) {
+        LOGERROR(F("OK"));
+
+        return true;
+    }
+
+    LOGERROR(F("failed"));
+
+    return false;
 }
 
 void conectarWiFi() {
     {
+        WM_SPAN_BEGIN(bootSpan, "conectarWiFi");
+
         // put your setup code here, to run once:
         // initialize the LED digital pin as an output.
         pinMode(PIN_LED, OUTPUT);
@@ -699,6 +968,8 @@ void conectarWiFi() {
 
         Serial.setDebugOutput(false);
 
+        WM_SPAN_BEGIN(fsSpan, "FileFS.begin");
+
         if (FORMAT_FILESYSTEM)
             FileFS.format();
 
@@ -732,8 +1003,14 @@ void conectarWiFi() {
             }
         }
 
+        WM_SPAN_END(fsSpan);
+
+        WM_SPAN_BEGIN(drdSpan, "DRD");
+
         drd = new DoubleResetDetector(DRD_TIMEOUT, DRD_ADDRESS);
 
+        WM_SPAN_END(drdSpan);
+
         unsigned long startedAt = millis();
 
         // New in v1.4.0
@@ -796,11 +1073,12 @@ void conectarWiFi() {
 
         bool configDataLoaded = false;
 
+        knownNetworks.load();
+
+        ESPAsync_wifiManager.setKnownNetworks(&knownNetworks);
+
         // From v1.1.0, Don't permit NULL password
         if ((Router_SSID != "") && (Router_Pass != "")) {
-            LOGERROR3(F("* Add SSID = "), Router_SSID, F(", PW = "), Router_Pass);
-            wifiMulti.addAP(Router_SSID.c_str(), Router_Pass.c_str());
-
             ESPAsync_wifiManager.setConfigPortalTimeout(120);  // If no access point name has been previously entered disable timeout.
             // Serial.println(F("Got ESP Self-Stored Credentials. Timeout 120s for Config Portal"));
         }
@@ -816,12 +1094,16 @@ void conectarWiFi() {
             if (strlen(WM_config.TZ_Name) > 0) {
                 LOGERROR3(F("Current TZ_Name ="), WM_config.TZ_Name, F(", TZ = "), WM_config.TZ);
 
+                WM_SPAN_BEGIN(ntpSpan, "NTP config");
+
 #if ESP8266
                 configTime(WM_config.TZ, "pool.ntp.org");
 #else
                 // configTzTime(WM_config.TZ, "pool.ntp.org" );
                 configTzTime(WM_config.TZ, "time.nist.gov", "0.pool.ntp.org", "1.pool.ntp.org");
 #endif
+
+                WM_SPAN_END(ntpSpan);
             } else {
                 Serial.println(F("Current Timezone is not set. Enter Config Portal to set."));
             }
@@ -869,6 +1151,8 @@ void conectarWiFi() {
                                                 WM_config.WiFi_Creds[1].wifi_ssid, WM_config.WiFi_Creds[1].wifi_pw);
 #endif
 
+            WM_SPAN_BEGIN(portalSpan, "startConfigPortal");
+
             // Starts an access point
             if (!ESPAsync_wifiManager.startConfigPortal((const char *)ssid.c_str(), password.c_str()))
                 Serial.println(F("Não conectado ao WiFi mas continua tentando."));
@@ -876,6 +1160,8 @@ void conectarWiFi() {
                 Serial.println(F("WiFi CONECTADO...EUREKA!! :)"));
             }
 
+            WM_SPAN_END(portalSpan);
+
             // Stored  for later usage, from v1.1.0, but clear first
             memset(&WM_config, 0, sizeof(WM_config));
 
@@ -893,11 +1179,6 @@ void conectarWiFi() {
                 else
                     strncpy(WM_config.WiFi_Creds[i].wifi_pw, tempPW.c_str(), sizeof(WM_config.WiFi_Creds[i].wifi_pw) - 1);
 
-                // Don't permit NULL SSID and password len < MIN_AP_PASSWORD_SIZE (8)
-                if ((String(WM_config.WiFi_Creds[i].wifi_ssid) != "") && (strlen(WM_config.WiFi_Creds[i].wifi_pw) >= MIN_AP_PASSWORD_SIZE)) {
-                    LOGERROR3(F("* Add SSID = "), WM_config.WiFi_Creds[i].wifi_ssid, F(", PW = "), WM_config.WiFi_Creds[i].wifi_pw);
-                    wifiMulti.addAP(WM_config.WiFi_Creds[i].wifi_ssid, WM_config.WiFi_Creds[i].wifi_pw);
-                }
             }
 
 #if USE_ESP_WIFIMANAGER_NTP
@@ -937,6 +1218,9 @@ void conectarWiFi() {
             saveConfigData();
         }
 
+        // Also migrates the credentials of a former WM_Config
+        addKnownNetworks();
+
         digitalWrite(PIN_LED, LED_OFF);  // Turn led off as we are not in configuration mode.
 
         startedAt = millis();
@@ -946,14 +1230,6 @@ void conectarWiFi() {
             if (!configDataLoaded)
                 loadConfigData();
 
-            for (uint8_t i = 0; i < NUM_WIFI_CREDENTIALS; i++) {
-                // Don't permit NULL SSID and password len < MIN_AP_PASSWORD_SIZE (8)
-                if ((String(WM_config.WiFi_Creds[i].wifi_ssid) != "") && (strlen(WM_config.WiFi_Creds[i].wifi_pw) >= MIN_AP_PASSWORD_SIZE)) {
-                    LOGERROR3(F("* Add SSID = "), WM_config.WiFi_Creds[i].wifi_ssid, F(", PW = "), WM_config.WiFi_Creds[i].wifi_pw);
-                    wifiMulti.addAP(WM_config.WiFi_Creds[i].wifi_ssid, WM_config.WiFi_Creds[i].wifi_pw);
-                }
-            }
-
             if (WiFi.status() != WL_CONNECTED) {
                 // Serial.println(F("ConnectMultiWiFi in setup"));
 
@@ -969,5 +1245,11 @@ void conectarWiFi() {
             Serial.println(F("\33[1;33mCONECTADO!!\033[0m."));
         } else
             Serial.println(ESPAsync_wifiManager.getStatus(WiFi.status()));
+
+        WM_SPAN_END(bootSpan);
+
+#if USE_WM_TIMELINE
+        ESPAsync_WMtimeline.print(Serial);
+#endif
     }
 }
\ No newline at end of file
@@ -0,0 +1,891 @@
+// autogenerated from utils/TZ.h by utils/gen_tz_index.py, do not edit
+
+#ifndef TZ_INDEX_H
+#define TZ_INDEX_H
+
+#include "TZ.h"
+
+#if USING_AFRICA
+
+// 52 timezones, 801 bytes of names, 77 bytes of distinct TZ strings
+const char     WM_TZ_AFRICA_NAMES[]         PROGMEM =
+  "Africa/Abidjan\0"
+  "Africa/Accra\0"
+  "Africa/Addis_Ababa\0"
+  "Africa/Algiers\0"
+  "Africa/Asmara\0"
+  "Africa/Bamako\0"
+  "Africa/Bangui\0"
+  "Africa/Banjul\0"
+  "Africa/Bissau\0"
+  "Africa/Blantyre\0"
+  "Africa/Brazzaville\0"
+  "Africa/Bujumbura\0"
+  "Africa/Cairo\0"
+  "Africa/Casablanca\0"
+  "Africa/Ceuta\0"
+  "Africa/Conakry\0"
+  "Africa/Dakar\0"
+  "Africa/Dar_es_Salaam\0"
+  "Africa/Djibouti\0"
+  "Africa/Douala\0"
+  "Africa/El_Aaiun\0"
+  "Africa/Freetown\0"
+  "Africa/Gaborone\0"
+  "Africa/Harare\0"
+  "Africa/Johannesburg\0"
+  "Africa/Juba\0"
+  "Africa/Kampala\0"
+  "Africa/Khartoum\0"
+  "Africa/Kigali\0"
+  "Africa/Kinshasa\0"
+  "Africa/Lagos\0"
+  "Africa/Libreville\0"
+  "Africa/Lome\0"
+  "Africa/Luanda\0"
+  "Africa/Lubumbashi\0"
+  "Africa/Lusaka\0"
+  "Africa/Malabo\0"
+  "Africa/Maputo\0"
+  "Africa/Maseru\0"
+  "Africa/Mbabane\0"
+  "Africa/Mogadishu\0"
+  "Africa/Monrovia\0"
+  "Africa/Nairobi\0"
+  "Africa/Ndjamena\0"
+  "Africa/Niamey\0"
+  "Africa/Nouakchott\0"
+  "Africa/Ouagadougou\0"
+  "Africa/PortomNovo\0"
+  "Africa/Sao_Tome\0"
+  "Africa/Tripoli\0"
+  "Africa/Tunis\0"
+  "Africa/Windhoek\0";
+
+const char     WM_TZ_AFRICA_VALUES[]        PROGMEM =
+  "GMT0\0"
+  "EAT-3\0"
+  "CET-1\0"
+  "WAT-1\0"
+  "CAT-2\0"
+  "EET-2\0"
+  "<+01>-1\0"
+  "CET-1CEST,M3.5.0,M10.5.0/3\0"
+  "SAST-2\0";
+
+// { name offset, value offset }, sorted by name
+const uint16_t WM_TZ_AFRICA_INDEX[][2]      PROGMEM =
+{
+  {    0,    0 }, {   15,    0 }, {   28,    5 }, {   47,   11 }, {   62,    5 }, {   76,    0 },
+  {   90,   17 }, {  104,    0 }, {  118,    0 }, {  132,   23 }, {  148,   17 }, {  167,   23 },
+  {  184,   29 }, {  197,   35 }, {  215,   43 }, {  228,    0 }, {  243,    0 }, {  256,    5 },
+  {  277,    5 }, {  293,   17 }, {  307,   35 }, {  323,    0 }, {  339,   23 }, {  355,   23 },
+  {  369,   70 }, {  389,    5 }, {  401,    5 }, {  416,   23 }, {  432,   23 }, {  446,   17 },
+  {  462,   17 }, {  475,   17 }, {  493,    0 }, {  505,   17 }, {  519,   23 }, {  537,   23 },
+  {  551,   17 }, {  565,   23 }, {  579,   70 }, {  593,   70 }, {  608,    5 }, {  625,    0 },
+  {  641,    5 }, {  656,   17 }, {  672,   17 }, {  686,    0 }, {  704,    0 }, {  723,   17 },
+  {  741,    0 }, {  757,   29 }, {  772,   11 }, {  785,   23 },
+};
+
+#endif    // USING_AFRICA
+
+#if USING_AMERICA
+
+// 148 timezones, 2809 bytes of names, 470 bytes of distinct TZ strings
+const char     WM_TZ_AMERICA_NAMES[]        PROGMEM =
+  "America/Adak\0"
+  "America/Anchorage\0"
+  "America/Anguilla\0"
+  "America/Antigua\0"
+  "America/Araguaina\0"
+  "America/Argentina/Buenos_Aires\0"
+  "America/Argentina/Catamarca\0"
+  "America/Argentina/Cordoba\0"
+  "America/Argentina/Jujuy\0"
+  "America/Argentina/La_Rioja\0"
+  "America/Argentina/Mendoza\0"
+  "America/Argentina/Rio_Gallegos\0"
+  "America/Argentina/Salta\0"
+  "America/Argentina/San_Juan\0"
+  "America/Argentina/San_Luis\0"
+  "America/Argentina/Tucuman\0"
+  "America/Argentina/Ushuaia\0"
+  "America/Aruba\0"
+  "America/Asuncion\0"
+  "America/Atikokan\0"
+  "America/Bahia\0"
+  "America/Bahia_Banderas\0"
+  "America/Barbados\0"
+  "America/Belem\0"
+  "America/Belize\0"
+  "America/BlancmSablon\0"
+  "America/Boa_Vista\0"
+  "America/Bogota\0"
+  "America/Boise\0"
+  "America/Cambridge_Bay\0"
+  "America/Campo_Grande\0"
+  "America/Cancun\0"
+  "America/Caracas\0"
+  "America/Cayenne\0"
+  "America/Cayman\0"
+  "America/Chicago\0"
+  "America/Chihuahua\0"
+  "America/Costa_Rica\0"
+  "America/Creston\0"
+  "America/Cuiaba\0"
+  "America/Curacao\0"
+  "America/Danmarkshavn\0"
+  "America/Dawson\0"
+  "America/Dawson_Creek\0"
+  "America/Denver\0"
+  "America/Detroit\0"
+  "America/Dominica\0"
+  "America/Edmonton\0"
+  "America/Eirunepe\0"
+  "America/El_Salvador\0"
+  "America/Fort_Nelson\0"
+  "America/Fortaleza\0"
+  "America/Glace_Bay\0"
+  "America/Godthab\0"
+  "America/Goose_Bay\0"
+  "America/Grand_Turk\0"
+  "America/Grenada\0"
+  "America/Guadeloupe\0"
+  "America/Guatemala\0"
+  "America/Guayaquil\0"
+  "America/Guyana\0"
+  "America/Halifax\0"
+  "America/Havana\0"
+  "America/Hermosillo\0"
+  "America/Indiana_Indianapolis\0"
+  "America/Indiana_Knox\0"
+  "America/Indiana_Marengo\0"
+  "America/Indiana_Petersburg\0"
+  "America/Indiana_Tell_City\0"
+  "America/Indiana_Vevay\0"
+  "America/Indiana_Vincennes\0"
+  "America/Indiana_Winamac\0"
+  "America/Inuvik\0"
+  "America/Iqaluit\0"
+  "America/Jamaica\0"
+  "America/Juneau\0"
+  "America/Kentucky_Louisville\0"
+  "America/Kentucky_Monticello\0"
+  "America/Kralendijk\0"
+  "America/La_Paz\0"
+  "America/Lima\0"
+  "America/Los_Angeles\0"
+  "America/Lower_Princes\0"
+  "America/Maceio\0"
+  "America/Managua\0"
+  "America/Manaus\0"
+  "America/Marigot\0"
+  "America/Martinique\0"
+  "America/Matamoros\0"
+  "America/Mazatlan\0"
+  "America/Menominee\0"
+  "America/Merida\0"
+  "America/Metlakatla\0"
+  "America/Mexico_City\0"
+  "America/Miquelon\0"
+  "America/Moncton\0"
+  "America/Monterrey\0"
+  "America/Montevideo\0"
+  "America/Montreal\0"
+  "America/Montserrat\0"
+  "America/Nassau\0"
+  "America/New_York\0"
+  "America/Nipigon\0"
+  "America/Nome\0"
+  "America/Noronha\0"
+  "America/North_Dakota_Beulah\0"
+  "America/North_Dakota_Center\0"
+  "America/North_Dakota_New_Salem\0"
+  "America/Ojinaga\0"
+  "America/Panama\0"
+  "America/Pangnirtung\0"
+  "America/Paramaribo\0"
+  "America/Phoenix\0"
+  "America/Port_of_Spain\0"
+  "America/PortmaumPrince\0"
+  "America/Porto_Velho\0"
+  "America/Puerto_Rico\0"
+  "America/Punta_Arenas\0"
+  "America/Rainy_River\0"
+  "America/Rankin_Inlet\0"
+  "America/Recife\0"
+  "America/Regina\0"
+  "America/Resolute\0"
+  "America/Rio_Branco\0"
+  "America/Santarem\0"
+  "America/Santiago\0"
+  "America/Santo_Domingo\0"
+  "America/Sao_Paulo\0"
+  "America/Scoresbysund\0"
+  "America/Sitka\0"
+  "America/St_Barthelemy\0"
+  "America/St_Johns\0"
+  "America/St_Kitts\0"
+  "America/St_Lucia\0"
+  "America/St_Thomas\0"
+  "America/St_Vincent\0"
+  "America/Swift_Current\0"
+  "America/Tegucigalpa\0"
+  "America/Thule\0"
+  "America/Thunder_Bay\0"
+  "America/Tijuana\0"
+  "America/Toronto\0"
+  "America/Tortola\0"
+  "America/Vancouver\0"
+  "America/Whitehorse\0"
+  "America/Winnipeg\0"
+  "America/Yakutat\0"
+  "America/Yellowknife\0";
+
+const char     WM_TZ_AMERICA_VALUES[]       PROGMEM =
+  "HST10HDT,M3.2.0,M11.1.0\0"
+  "AKST9AKDT,M3.2.0,M11.1.0\0"
+  "AST4\0"
+  "<-03>3\0"
+  "<-04>4<-03>,M10.1.0/0,M3.4.0/0\0"
+  "EST5\0"
+  "CST6CDT,M4.1.0,M10.5.0\0"
+  "CST6\0"
+  "<-04>4\0"
+  "<-05>5\0"
+  "MST7MDT,M3.2.0,M11.1.0\0"
+  "CST6CDT,M3.2.0,M11.1.0\0"
+  "MST7MDT,M4.1.0,M10.5.0\0"
+  "MST7\0"
+  "GMT0\0"
+  "EST5EDT,M3.2.0,M11.1.0\0"
+  "AST4ADT,M3.2.0,M11.1.0\0"
+  "<-03>3<-02>,M3.5.0/-2,M10.5.0/-1\0"
+  "CST5CDT,M3.2.0/0,M11.1.0/1\0"
+  "PST8PDT,M3.2.0,M11.1.0\0"
+  "<-03>3<-02>,M3.2.0,M11.1.0\0"
+  "<-02>2\0"
+  "<-04>4<-03>,M9.1.6/24,M4.1.6/24\0"
+  "<-01>1<+00>,M3.5.0/0,M10.5.0/1\0"
+  "NST3:30NDT,M3.2.0,M11.1.0\0";
+
+// { name offset, value offset }, sorted by name
+const uint16_t WM_TZ_AMERICA_INDEX[][2]     PROGMEM =
+{
+  {    0,    0 }, {   13,   24 }, {   31,   49 }, {   48,   49 }, {   64,   54 }, {   82,   54 },
+  {  113,   54 }, {  141,   54 }, {  167,   54 }, {  191,   54 }, {  218,   54 }, {  244,   54 },
+  {  275,   54 }, {  299,   54 }, {  326,   54 }, {  353,   54 }, {  379,   54 }, {  405,   49 },
+  {  419,   61 }, {  436,   92 }, {  453,   54 }, {  467,   97 }, {  490,   49 }, {  507,   54 },
+  {  521,  120 }, {  536,   49 }, {  557,  125 }, {  575,  132 }, {  590,  139 }, {  604,  139 },
+  {  626,  125 }, {  647,   92 }, {  662,  125 }, {  678,   54 }, {  694,   92 }, {  709,  162 },
+  {  725,  185 }, {  743,  120 }, {  762,  208 }, {  778,  125 }, {  793,   49 }, {  809,  213 },
+  {  830,  208 }, {  845,  208 }, {  866,  139 }, {  881,  218 }, {  897,   49 }, {  914,  139 },
+  {  931,  132 }, {  948,  120 }, {  968,  208 }, {  988,   54 }, { 1006,  241 }, { 1024,  264 },
+  { 1040,  241 }, { 1058,  218 }, { 1077,   49 }, { 1093,   49 }, { 1112,  120 }, { 1130,  132 },
+  { 1148,  125 }, { 1163,  241 }, { 1179,  297 }, { 1194,  208 }, { 1213,  218 }, { 1242,  162 },
+  { 1263,  218 }, { 1287,  218 }, { 1314,  162 }, { 1340,  218 }, { 1362,  218 }, { 1388,  218 },
+  { 1412,  139 }, { 1427,  218 }, { 1443,   92 }, { 1459,   24 }, { 1474,  218 }, { 1502,  218 },
+  { 1530,   49 }, { 1549,  125 }, { 1564,  132 }, { 1577,  324 }, { 1597,   49 }, { 1619,   54 },
+  { 1634,  120 }, { 1650,  125 }, { 1665,   49 }, { 1681,   49 }, { 1700,  162 }, { 1718,  185 },
+  { 1735,  162 }, { 1753,   97 }, { 1768,   24 }, { 1787,   97 }, { 1807,  347 }, { 1824,  241 },
+  { 1840,   97 }, { 1858,   54 }, { 1877,  218 }, { 1894,   49 }, { 1913,  218 }, { 1928,  218 },
+  { 1945,  218 }, { 1961,   24 }, { 1974,  374 }, { 1990,  162 }, { 2018,  162 }, { 2046,  162 },
+  { 2077,  139 }, { 2093,   92 }, { 2108,  218 }, { 2128,   54 }, { 2147,  208 }, { 2163,   49 },
+  { 2185,  218 }, { 2208,  125 }, { 2228,   49 }, { 2248,   54 }, { 2269,  162 }, { 2289,  162 },
+  { 2310,   54 }, { 2325,  120 }, { 2340,  162 }, { 2357,  132 }, { 2376,   54 }, { 2393,  381 },
+  { 2410,   49 }, { 2432,   54 }, { 2450,  413 }, { 2471,   24 }, { 2485,   49 }, { 2507,  444 },
+  { 2524,   49 }, { 2541,   49 }, { 2558,   49 }, { 2576,   49 }, { 2595,  120 }, { 2617,  120 },
+  { 2637,  241 }, { 2651,  218 }, { 2671,  324 }, { 2687,  218 }, { 2703,   49 }, { 2719,  324 },
+  { 2737,  208 }, { 2756,  162 }, { 2773,   24 }, { 2789,  139 },
+};
+
+#endif    // USING_AMERICA
+
+#if USING_ANTARCTICA
+
+// 12 timezones, 227 bytes of names, 174 bytes of distinct TZ strings
+const char     WM_TZ_ANTARCTICA_NAMES[]     PROGMEM =
+  "Antarctica/Casey\0"
+  "Antarctica/Davis\0"
+  "Antarctica/DumontDUrville\0"
+  "Antarctica/Macquarie\0"
+  "Antarctica/Mawson\0"
+  "Antarctica/McMurdo\0"
+  "Antarctica/Palmer\0"
+  "Antarctica/Rothera\0"
+  "Antarctica/Syowa\0"
+  "Antarctica/Troll\0"
+  "Antarctica/Vostok\0"
+  "Arctic/Longyearbyen\0";
+
+const char     WM_TZ_ANTARCTICA_VALUES[]    PROGMEM =
+  "<+11>-11\0"
+  "<+07>-7\0"
+  "<+10>-10\0"
+  "AEST-10AEDT,M10.1.0,M4.1.0/3\0"
+  "<+05>-5\0"
+  "NZST-12NZDT,M9.5.0,M4.1.0/3\0"
+  "<-03>3\0"
+  "<+03>-3\0"
+  "<+00>0<+02>-2,M3.5.0/1,M10.5.0/3\0"
+  "<+06>-6\0"
+  "CET-1CEST,M3.5.0,M10.5.0/3\0";
+
+// { name offset, value offset }, sorted by name
+const uint16_t WM_TZ_ANTARCTICA_INDEX[][2]  PROGMEM =
+{
+  {    0,    0 }, {   17,    9 }, {   34,   17 }, {   60,   26 }, {   81,   55 }, {   99,   63 },
+  {  118,   91 }, {  136,   91 }, {  155,   98 }, {  172,  106 }, {  189,  139 }, {  207,  147 },
+};
+
+#endif    // USING_ANTARCTICA
+
+#if USING_ASIA
+
+// 82 timezones, 1088 bytes of names, 409 bytes of distinct TZ strings
+const char     WM_TZ_ASIA_NAMES[]           PROGMEM =
+  "Asia/Aden\0"
+  "Asia/Almaty\0"
+  "Asia/Amman\0"
+  "Asia/Anadyr\0"
+  "Asia/Aqtau\0"
+  "Asia/Aqtobe\0"
+  "Asia/Ashgabat\0"
+  "Asia/Atyrau\0"
+  "Asia/Baghdad\0"
+  "Asia/Bahrain\0"
+  "Asia/Baku\0"
+  "Asia/Bangkok\0"
+  "Asia/Barnaul\0"
+  "Asia/Beirut\0"
+  "Asia/Bishkek\0"
+  "Asia/Brunei\0"
+  "Asia/Chita\0"
+  "Asia/Choibalsan\0"
+  "Asia/Colombo\0"
+  "Asia/Damascus\0"
+  "Asia/Dhaka\0"
+  "Asia/Dili\0"
+  "Asia/Dubai\0"
+  "Asia/Dushanbe\0"
+  "Asia/Famagusta\0"
+  "Asia/Gaza\0"
+  "Asia/Hebron\0"
+  "Asia/Ho_Chi_Minh\0"
+  "Asia/Hong_Kong\0"
+  "Asia/Hovd\0"
+  "Asia/Irkutsk\0"
+  "Asia/Jakarta\0"
+  "Asia/Jayapura\0"
+  "Asia/Jerusalem\0"
+  "Asia/Kabul\0"
+  "Asia/Kamchatka\0"
+  "Asia/Karachi\0"
+  "Asia/Kathmandu\0"
+  "Asia/Khandyga\0"
+  "Asia/Kolkata\0"
+  "Asia/Krasnoyarsk\0"
+  "Asia/Kuala_Lumpur\0"
+  "Asia/Kuching\0"
+  "Asia/Kuwait\0"
+  "Asia/Macau\0"
+  "Asia/Magadan\0"
+  "Asia/Makassar\0"
+  "Asia/Manila\0"
+  "Asia/Muscat\0"
+  "Asia/Nicosia\0"
+  "Asia/Novokuznetsk\0"
+  "Asia/Novosibirsk\0"
+  "Asia/Omsk\0"
+  "Asia/Oral\0"
+  "Asia/Phnom_Penh\0"
+  "Asia/Pontianak\0"
+  "Asia/Pyongyang\0"
+  "Asia/Qatar\0"
+  "Asia/Qyzylorda\0"
+  "Asia/Riyadh\0"
+  "Asia/Sakhalin\0"
+  "Asia/Samarkand\0"
+  "Asia/Seoul\0"
+  "Asia/Shanghai\0"
+  "Asia/Singapore\0"
+  "Asia/Srednekolymsk\0"
+  "Asia/Taipei\0"
+  "Asia/Tashkent\0"
+  "Asia/Tbilisi\0"
+  "Asia/Tehran\0"
+  "Asia/Thimphu\0"
+  "Asia/Tokyo\0"
+  "Asia/Tomsk\0"
+  "Asia/Ulaanbaatar\0"
+  "Asia/Urumqi\0"
+  "Asia/UstmNera\0"
+  "Asia/Vientiane\0"
+  "Asia/Vladivostok\0"
+  "Asia/Yakutsk\0"
+  "Asia/Yangon\0"
+  "Asia/Yekaterinburg\0"
+  "Asia/Yerevan\0";
+
+const char     WM_TZ_ASIA_VALUES[]          PROGMEM =
+  "<+03>-3\0"
+  "<+06>-6\0"
+  "EET-2EEST,M3.5.4/24,M10.5.5/1\0"
+  "<+12>-12\0"
+  "<+05>-5\0"
+  "<+04>-4\0"
+  "<+07>-7\0"
+  "EET-2EEST,M3.5.0/0,M10.5.0/0\0"
+  "<+08>-8\0"
+  "<+09>-9\0"
+  "<+0530>-5:30\0"
+  "EET-2EEST,M3.5.5/0,M10.5.5/0\0"
+  "EET-2EEST,M3.5.0/3,M10.5.0/4\0"
+  "EET-2EEST,M3.4.4/48,M10.4.4/49\0"
+  "HKT-8\0"
+  "WIB-7\0"
+  "WIT-9\0"
+  "IST-2IDT,M3.4.4/26,M10.5.0\0"
+  "<+0430>-4:30\0"
+  "PKT-5\0"
+  "<+0545>-5:45\0"
+  "IST-5:30\0"
+  "CST-8\0"
+  "<+11>-11\0"
+  "WITA-8\0"
+  "PST-8\0"
+  "KST-9\0"
+  "<+0330>-3:30<+0430>,J79/24,J263/24\0"
+  "JST-9\0"
+  "<+10>-10\0"
+  "<+0630>-6:30\0";
+
+// { name offset, value offset }, sorted by name
+const uint16_t WM_TZ_ASIA_INDEX[][2]        PROGMEM =
+{
+  {    0,    0 }, {   10,    8 }, {   22,   16 }, {   33,   46 }, {   45,   55 }, {   56,   55 },
+  {   68,   55 }, {   82,   55 }, {   94,    0 }, {  107,    0 }, {  120,   63 }, {  130,   71 },
+  {  143,   71 }, {  156,   79 }, {  168,    8 }, {  181,  108 }, {  193,  116 }, {  204,  108 },
+  {  220,  124 }, {  233,  137 }, {  247,    8 }, {  258,  116 }, {  268,   63 }, {  279,   55 },
+  {  293,  166 }, {  308,  195 }, {  318,  195 }, {  330,   71 }, {  347,  226 }, {  362,   71 },
+  {  372,  108 }, {  385,  232 }, {  398,  238 }, {  412,  244 }, {  427,  271 }, {  438,   46 },
+  {  453,  284 }, {  466,  290 }, {  481,  116 }, {  495,  303 }, {  508,   71 }, {  525,  108 },
+  {  543,  108 }, {  556,    0 }, {  568,  312 }, {  579,  318 }, {  592,  327 }, {  606,  334 },
+  {  618,   63 }, {  630,  166 }, {  643,   71 }, {  661,   71 }, {  678,    8 }, {  688,   55 },
+  {  698,   71 }, {  714,  232 }, {  729,  340 }, {  744,    0 }, {  755,   55 }, {  770,    0 },
+  {  782,  318 }, {  796,   55 }, {  811,  340 }, {  822,  312 }, {  836,  108 }, {  851,  318 },
+  {  870,  312 }, {  882,   55 }, {  896,   63 }, {  909,  346 }, {  921,    8 }, {  934,  381 },
+  {  945,   71 }, {  956,  108 }, {  973,    8 }, {  985,  387 }, {  999,   71 }, { 1014,  387 },
+  { 1031,  116 }, { 1044,  396 }, { 1056,   55 }, { 1075,   63 },
+};
+
+#endif    // USING_ASIA
+
+#if USING_ATLANTIC
+
+// 10 timezones, 179 bytes of names, 106 bytes of distinct TZ strings
+const char     WM_TZ_ATLANTIC_NAMES[]       PROGMEM =
+  "Atlantic/Azores\0"
+  "Atlantic/Bermuda\0"
+  "Atlantic/Canary\0"
+  "Atlantic/Cape_Verde\0"
+  "Atlantic/Faroe\0"
+  "Atlantic/Madeira\0"
+  "Atlantic/Reykjavik\0"
+  "Atlantic/South_Georgia\0"
+  "Atlantic/St_Helena\0"
+  "Atlantic/Stanley\0";
+
+const char     WM_TZ_ATLANTIC_VALUES[]      PROGMEM =
+  "<-01>1<+00>,M3.5.0/0,M10.5.0/1\0"
+  "AST4ADT,M3.2.0,M11.1.0\0"
+  "WET0WEST,M3.5.0/1,M10.5.0\0"
+  "<-01>1\0"
+  "GMT0\0"
+  "<-02>2\0"
+  "<-03>3\0";
+
+// { name offset, value offset }, sorted by name
+const uint16_t WM_TZ_ATLANTIC_INDEX[][2]    PROGMEM =
+{
+  {    0,    0 }, {   16,   31 }, {   33,   54 }, {   49,   80 }, {   69,   54 }, {   84,   54 },
+  {  101,   87 }, {  120,   92 }, {  143,   87 }, {  162,   99 },
+};
+
+#endif    // USING_ATLANTIC
+
+#if USING_AUSTRALIA
+
+// 12 timezones, 219 bytes of names, 135 bytes of distinct TZ strings
+const char     WM_TZ_AUSTRALIA_NAMES[]      PROGMEM =
+  "Australia/Adelaide\0"
+  "Australia/Brisbane\0"
+  "Australia/Broken_Hill\0"
+  "Australia/Currie\0"
+  "Australia/Darwin\0"
+  "Australia/Eucla\0"
+  "Australia/Hobart\0"
+  "Australia/Lindeman\0"
+  "Australia/Lord_Howe\0"
+  "Australia/Melbourne\0"
+  "Australia/Perth\0"
+  "Australia/Sydney\0";
+
+const char     WM_TZ_AUSTRALIA_VALUES[]     PROGMEM =
+  "ACST-9:30ACDT,M10.1.0,M4.1.0/3\0"
+  "AEST-10\0"
+  "AEST-10AEDT,M10.1.0,M4.1.0/3\0"
+  "ACST-9:30\0"
+  "<+0845>-8:45\0"
+  "<+1030>-10:30<+11>-11,M10.1.0,M4.1.0\0"
+  "AWST-8\0";
+
+// { name offset, value offset }, sorted by name
+const uint16_t WM_TZ_AUSTRALIA_INDEX[][2]   PROGMEM =
+{
+  {    0,    0 }, {   19,   31 }, {   38,    0 }, {   60,   39 }, {   77,   68 }, {   94,   78 },
+  {  110,   39 }, {  127,   31 }, {  146,   91 }, {  166,   39 }, {  186,  128 }, {  202,   39 },
+};
+
+#endif    // USING_AUSTRALIA
+
+#if USING_EUROPE
+
+// 60 timezones, 915 bytes of names, 189 bytes of distinct TZ strings
+const char     WM_TZ_EUROPE_NAMES[]         PROGMEM =
+  "Europe/Amsterdam\0"
+  "Europe/Andorra\0"
+  "Europe/Astrakhan\0"
+  "Europe/Athens\0"
+  "Europe/Belgrade\0"
+  "Europe/Berlin\0"
+  "Europe/Bratislava\0"
+  "Europe/Brussels\0"
+  "Europe/Bucharest\0"
+  "Europe/Budapest\0"
+  "Europe/Busingen\0"
+  "Europe/Chisinau\0"
+  "Europe/Copenhagen\0"
+  "Europe/Dublin\0"
+  "Europe/Gibraltar\0"
+  "Europe/Guernsey\0"
+  "Europe/Helsinki\0"
+  "Europe/Isle_of_Man\0"
+  "Europe/Istanbul\0"
+  "Europe/Jersey\0"
+  "Europe/Kaliningrad\0"
+  "Europe/Kiev\0"
+  "Europe/Kirov\0"
+  "Europe/Lisbon\0"
+  "Europe/Ljubljana\0"
+  "Europe/London\0"
+  "Europe/Luxembourg\0"
+  "Europe/Madrid\0"
+  "Europe/Malta\0"
+  "Europe/Mariehamn\0"
+  "Europe/Minsk\0"
+  "Europe/Monaco\0"
+  "Europe/Moscow\0"
+  "Europe/Oslo\0"
+  "Europe/Paris\0"
+  "Europe/Podgorica\0"
+  "Europe/Prague\0"
+  "Europe/Riga\0"
+  "Europe/Rome\0"
+  "Europe/Samara\0"
+  "Europe/San_Marino\0"
+  "Europe/Sarajevo\0"
+  "Europe/Saratov\0"
+  "Europe/Simferopol\0"
+  "Europe/Skopje\0"
+  "Europe/Sofia\0"
+  "Europe/Stockholm\0"
+  "Europe/Tallinn\0"
+  "Europe/Tirane\0"
+  "Europe/Ulyanovsk\0"
+  "Europe/Uzhgorod\0"
+  "Europe/Vaduz\0"
+  "Europe/Vatican\0"
+  "Europe/Vienna\0"
+  "Europe/Vilnius\0"
+  "Europe/Volgograd\0"
+  "Europe/Warsaw\0"
+  "Europe/Zagreb\0"
+  "Europe/Zaporozhye\0"
+  "Europe/Zurich\0";
+
+const char     WM_TZ_EUROPE_VALUES[]        PROGMEM =
+  "CET-1CEST,M3.5.0,M10.5.0/3\0"
+  "<+04>-4\0"
+  "EET-2EEST,M3.5.0/3,M10.5.0/4\0"
+  "EET-2EEST,M3.5.0,M10.5.0/3\0"
+  "IST-1GMT0,M10.5.0,M3.5.0/1\0"
+  "GMT0BST,M3.5.0/1,M10.5.0\0"
+  "<+03>-3\0"
+  "EET-2\0"
+  "WET0WEST,M3.5.0/1,M10.5.0\0"
+  "MSK-3\0";
+
+// { name offset, value offset }, sorted by name
+const uint16_t WM_TZ_EUROPE_INDEX[][2]      PROGMEM =
+{
+  {    0,    0 }, {   17,    0 }, {   32,   27 }, {   49,   35 }, {   63,    0 }, {   79,    0 },
+  {   93,    0 }, {  111,    0 }, {  127,   35 }, {  144,    0 }, {  160,    0 }, {  176,   64 },
+  {  192,    0 }, {  210,   91 }, {  224,    0 }, {  241,  118 }, {  257,   35 }, {  273,  118 },
+  {  292,  143 }, {  308,  118 }, {  322,  151 }, {  341,   35 }, {  353,  143 }, {  366,  157 },
+  {  380,    0 }, {  397,  118 }, {  411,    0 }, {  429,    0 }, {  443,    0 }, {  456,   35 },
+  {  473,  143 }, {  486,    0 }, {  500,  183 }, {  514,    0 }, {  526,    0 }, {  539,    0 },
+  {  556,    0 }, {  570,   35 }, {  582,    0 }, {  594,   27 }, {  608,    0 }, {  626,    0 },
+  {  642,   27 }, {  657,  183 }, {  675,    0 }, {  689,   35 }, {  702,    0 }, {  719,   35 },
+  {  734,    0 }, {  748,   27 }, {  765,   35 }, {  781,    0 }, {  794,    0 }, {  809,    0 },
+  {  823,   35 }, {  838,   27 }, {  855,    0 }, {  869,    0 }, {  883,   35 }, {  901,    0 },
+};
+
+#endif    // USING_EUROPE
+
+#if USING_INDIAN
+
+// 11 timezones, 170 bytes of names, 51 bytes of distinct TZ strings
+const char     WM_TZ_INDIAN_NAMES[]         PROGMEM =
+  "Indian/Antananarivo\0"
+  "Indian/Chagos\0"
+  "Indian/Christmas\0"
+  "Indian/Cocos\0"
+  "Indian/Comoro\0"
+  "Indian/Kerguelen\0"
+  "Indian/Mahe\0"
+  "Indian/Maldives\0"
+  "Indian/Mauritius\0"
+  "Indian/Mayotte\0"
+  "Indian/Reunion\0";
+
+const char     WM_TZ_INDIAN_VALUES[]        PROGMEM =
+  "EAT-3\0"
+  "<+06>-6\0"
+  "<+07>-7\0"
+  "<+0630>-6:30\0"
+  "<+05>-5\0"
+  "<+04>-4\0";
+
+// { name offset, value offset }, sorted by name
+const uint16_t WM_TZ_INDIAN_INDEX[][2]      PROGMEM =
+{
+  {    0,    0 }, {   20,    6 }, {   34,   14 }, {   51,   22 }, {   64,    0 }, {   78,   35 },
+  {   95,   43 }, {  107,   35 }, {  123,   43 }, {  140,    0 }, {  155,   43 },
+};
+
+#endif    // USING_INDIAN
+
+#if USING_PACIFIC
+
+// 38 timezones, 611 bytes of names, 322 bytes of distinct TZ strings
+const char     WM_TZ_PACIFIC_NAMES[]        PROGMEM =
+  "Pacific/Apia\0"
+  "Pacific/Auckland\0"
+  "Pacific/Bougainville\0"
+  "Pacific/Chatham\0"
+  "Pacific/Chuuk\0"
+  "Pacific/Easter\0"
+  "Pacific/Efate\0"
+  "Pacific/Enderbury\0"
+  "Pacific/Fakaofo\0"
+  "Pacific/Fiji\0"
+  "Pacific/Funafuti\0"
+  "Pacific/Galapagos\0"
+  "Pacific/Gambier\0"
+  "Pacific/Guadalcanal\0"
+  "Pacific/Guam\0"
+  "Pacific/Honolulu\0"
+  "Pacific/Kiritimati\0"
+  "Pacific/Kosrae\0"
+  "Pacific/Kwajalein\0"
+  "Pacific/Majuro\0"
+  "Pacific/Marquesas\0"
+  "Pacific/Midway\0"
+  "Pacific/Nauru\0"
+  "Pacific/Niue\0"
+  "Pacific/Norfolk\0"
+  "Pacific/Noumea\0"
+  "Pacific/Pago_Pago\0"
+  "Pacific/Palau\0"
+  "Pacific/Pitcairn\0"
+  "Pacific/Pohnpei\0"
+  "Pacific/Port_Moresby\0"
+  "Pacific/Rarotonga\0"
+  "Pacific/Saipan\0"
+  "Pacific/Tahiti\0"
+  "Pacific/Tarawa\0"
+  "Pacific/Tongatapu\0"
+  "Pacific/Wake\0"
+  "Pacific/Wallis\0";
+
+const char     WM_TZ_PACIFIC_VALUES[]       PROGMEM =
+  "<+13>-13<+14>,M9.5.0/3,M4.1.0/4\0"
+  "NZST-12NZDT,M9.5.0,M4.1.0/3\0"
+  "<+11>-11\0"
+  "<+1245>-12:45<+1345>,M9.5.0/2:45,M4.1.0/3:45\0"
+  "<+10>-10\0"
+  "<-06>6<-05>,M9.1.6/22,M4.1.6/22\0"
+  "<+13>-13\0"
+  "<+12>-12<+13>,M11.2.0,M1.2.3/99\0"
+  "<+12>-12\0"
+  "<-06>6\0"
+  "<-09>9\0"
+  "ChST-10\0"
+  "HST10\0"
+  "<+14>-14\0"
+  "<-0930>9:30\0"
+  "SST11\0"
+  "<-11>11\0"
+  "<+11>-11<+12>,M10.1.0,M4.1.0/3\0"
+  "<+09>-9\0"
+  "<-08>8\0"
+  "<-10>10\0";
+
+// { name offset, value offset }, sorted by name
+const uint16_t WM_TZ_PACIFIC_INDEX[][2]     PROGMEM =
+{
+  {    0,    0 }, {   13,   32 }, {   30,   60 }, {   51,   69 }, {   67,  114 }, {   81,  123 },
+  {   96,   60 }, {  110,  155 }, {  128,  155 }, {  144,  164 }, {  157,  196 }, {  174,  205 },
+  {  192,  212 }, {  208,   60 }, {  228,  219 }, {  241,  227 }, {  258,  233 }, {  277,   60 },
+  {  292,  196 }, {  310,  196 }, {  325,  242 }, {  343,  254 }, {  358,  196 }, {  372,  260 },
+  {  385,  268 }, {  401,   60 }, {  416,  254 }, {  434,  299 }, {  448,  307 }, {  465,   60 },
+  {  481,  114 }, {  502,  314 }, {  520,  219 }, {  535,  314 }, {  550,  196 }, {  565,  155 },
+  {  583,  196 }, {  596,  196 },
+};
+
+#endif    // USING_PACIFIC
+
+#if USING_ETC_GMT
+
+// 35 timezones, 358 bytes of names, 214 bytes of distinct TZ strings
+const char     WM_TZ_ETC_GMT_NAMES[]        PROGMEM =
+  "Etc/GMT\0"
+  "Etc/GMT0\0"
+  "Etc/GMTm0\0"
+  "Etc/GMTm1\0"
+  "Etc/GMTm10\0"
+  "Etc/GMTm11\0"
+  "Etc/GMTm12\0"
+  "Etc/GMTm13\0"
+  "Etc/GMTm14\0"
+  "Etc/GMTm2\0"
+  "Etc/GMTm3\0"
+  "Etc/GMTm4\0"
+  "Etc/GMTm5\0"
+  "Etc/GMTm6\0"
+  "Etc/GMTm7\0"
+  "Etc/GMTm8\0"
+  "Etc/GMTm9\0"
+  "Etc/GMTp0\0"
+  "Etc/GMTp1\0"
+  "Etc/GMTp10\0"
+  "Etc/GMTp11\0"
+  "Etc/GMTp12\0"
+  "Etc/GMTp2\0"
+  "Etc/GMTp3\0"
+  "Etc/GMTp4\0"
+  "Etc/GMTp5\0"
+  "Etc/GMTp6\0"
+  "Etc/GMTp7\0"
+  "Etc/GMTp8\0"
+  "Etc/GMTp9\0"
+  "Etc/Greenwich\0"
+  "Etc/UCT\0"
+  "Etc/UTC\0"
+  "Etc/Universal\0"
+  "Etc/Zulu\0";
+
+const char     WM_TZ_ETC_GMT_VALUES[]       PROGMEM =
+  "GMT0\0"
+  "<+01>-1\0"
+  "<+10>-10\0"
+  "<+11>-11\0"
+  "<+12>-12\0"
+  "<+13>-13\0"
+  "<+14>-14\0"
+  "<+02>-2\0"
+  "<+03>-3\0"
+  "<+04>-4\0"
+  "<+05>-5\0"
+  "<+06>-6\0"
+  "<+07>-7\0"
+  "<+08>-8\0"
+  "<+09>-9\0"
+  "<-01>1\0"
+  "<-10>10\0"
+  "<-11>11\0"
+  "<-12>12\0"
+  "<-02>2\0"
+  "<-03>3\0"
+  "<-04>4\0"
+  "<-05>5\0"
+  "<-06>6\0"
+  "<-07>7\0"
+  "<-08>8\0"
+  "<-09>9\0"
+  "UTC0\0";
+
+// { name offset, value offset }, sorted by name
+const uint16_t WM_TZ_ETC_GMT_INDEX[][2]     PROGMEM =
+{
+  {    0,    0 }, {    8,    0 }, {   17,    0 }, {   27,    5 }, {   37,   13 }, {   48,   22 },
+  {   59,   31 }, {   70,   40 }, {   81,   49 }, {   92,   58 }, {  102,   66 }, {  112,   74 },
+  {  122,   82 }, {  132,   90 }, {  142,   98 }, {  152,  106 }, {  162,  114 }, {  172,    0 },
+  {  182,  122 }, {  192,  129 }, {  203,  137 }, {  214,  145 }, {  225,  153 }, {  235,  160 },
+  {  245,  167 }, {  255,  174 }, {  265,  181 }, {  275,  188 }, {  285,  195 }, {  295,  202 },
+  {  305,    0 }, {  319,  209 }, {  327,  209 }, {  335,  209 }, {  349,  209 },
+};
+
+#endif    // USING_ETC_GMT
+
+////////////////////////////////////////////////////////////
+
+// Longest POSIX TZ string, over all regions
+#define WM_TZ_VALUE_MAX_LEN       44
+
+typedef struct
+{
+  PGM_P             names;
+  PGM_P             values;
+  const uint16_t    (*index)[2];
+  uint16_t          count;
+} WM_TZ_Region;
+
+// Enabled USING_<REGION> groups. The names are sorted within a region, not across regions
+static const WM_TZ_Region WM_TZ_REGIONS[] =
+{
+#if USING_AFRICA
+  { WM_TZ_AFRICA_NAMES, WM_TZ_AFRICA_VALUES, WM_TZ_AFRICA_INDEX, sizeof(WM_TZ_AFRICA_INDEX) / sizeof(WM_TZ_AFRICA_INDEX[0]) },
+#endif
+#if USING_AMERICA
+  { WM_TZ_AMERICA_NAMES, WM_TZ_AMERICA_VALUES, WM_TZ_AMERICA_INDEX, sizeof(WM_TZ_AMERICA_INDEX) / sizeof(WM_TZ_AMERICA_INDEX[0]) },
+#endif
+#if USING_ANTARCTICA
+  { WM_TZ_ANTARCTICA_NAMES, WM_TZ_ANTARCTICA_VALUES, WM_TZ_ANTARCTICA_INDEX, sizeof(WM_TZ_ANTARCTICA_INDEX) / sizeof(WM_TZ_ANTARCTICA_INDEX[0]) },
+#endif
+#if USING_ASIA
+  { WM_TZ_ASIA_NAMES, WM_TZ_ASIA_VALUES, WM_TZ_ASIA_INDEX, sizeof(WM_TZ_ASIA_INDEX) / sizeof(WM_TZ_ASIA_INDEX[0]) },
+#endif
+#if USING_ATLANTIC
+  { WM_TZ_ATLANTIC_NAMES, WM_TZ_ATLANTIC_VALUES, WM_TZ_ATLANTIC_INDEX, sizeof(WM_TZ_ATLANTIC_INDEX) / sizeof(WM_TZ_ATLANTIC_INDEX[0]) },
+#endif
+#if USING_AUSTRALIA
+  { WM_TZ_AUSTRALIA_NAMES, WM_TZ_AUSTRALIA_VALUES, WM_TZ_AUSTRALIA_INDEX, sizeof(WM_TZ_AUSTRALIA_INDEX) / sizeof(WM_TZ_AUSTRALIA_INDEX[0]) },
+#endif
+#if USING_EUROPE
+  { WM_TZ_EUROPE_NAMES, WM_TZ_EUROPE_VALUES, WM_TZ_EUROPE_INDEX, sizeof(WM_TZ_EUROPE_INDEX) / sizeof(WM_TZ_EUROPE_INDEX[0]) },
+#endif
+#if USING_INDIAN
+  { WM_TZ_INDIAN_NAMES, WM_TZ_INDIAN_VALUES, WM_TZ_INDIAN_INDEX, sizeof(WM_TZ_INDIAN_INDEX) / sizeof(WM_TZ_INDIAN_INDEX[0]) },
+#endif
+#if USING_PACIFIC
+  { WM_TZ_PACIFIC_NAMES, WM_TZ_PACIFIC_VALUES, WM_TZ_PACIFIC_INDEX, sizeof(WM_TZ_PACIFIC_INDEX) / sizeof(WM_TZ_PACIFIC_INDEX[0]) },
+#endif
+#if USING_ETC_GMT
+  { WM_TZ_ETC_GMT_NAMES, WM_TZ_ETC_GMT_VALUES, WM_TZ_ETC_GMT_INDEX, sizeof(WM_TZ_ETC_GMT_INDEX) / sizeof(WM_TZ_ETC_GMT_INDEX[0]) },
+#endif
+  { NULL, NULL, NULL, 0 }    // End of the enabled regions
+};
+
+#endif    // TZ_INDEX_H
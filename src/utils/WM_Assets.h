@@ -0,0 +1,201 @@
+// autogenerated from utils/assets by utils/gen_assets.py, do not edit
+
+#ifndef WM_ASSETS_H
+#define WM_ASSETS_H
+
+// wm.css : 1471 bytes, 834 gzipped
+const char    WM_ASSET_CSS_ETAG[]            = "\"2eb4c30799b98fd8\"";
+const char    WM_ASSET_CSS_TAG[]   PROGMEM   = "<link rel='stylesheet' href='/wm.css?v=2eb4c30799b98fd8'>";
+const uint8_t WM_ASSET_CSS_GZ[]    PROGMEM   =
+{
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x95, 0x54, 0x6b, 0x6f, 0xa3, 0x38,
+  0x14, 0xfd, 0x2b, 0x48, 0xd5, 0xa8, 0xed, 0x28, 0x24, 0x90, 0x57, 0x0b, 0xa8, 0xa3, 0x4d, 0x32,
+  0x34, 0x6d, 0x27, 0x4d, 0xda, 0x66, 0x92, 0xc9, 0x64, 0xb5, 0x1f, 0x0c, 0x36, 0xc6, 0x05, 0x6c,
+  0x0a, 0x4e, 0x20, 0x41, 0xfc, 0xf7, 0xb5, 0x93, 0x92, 0x26, 0xdd, 0x95, 0x56, 0xcb, 0x17, 0xec,
+  0xeb, 0xfb, 0x38, 0xf7, 0x9e, 0x63, 0x43, 0xb2, 0x2e, 0x62, 0x00, 0x21, 0xa1, 0xd8, 0x6c, 0xc6,
+  0xb9, 0xe5, 0x31, 0xca, 0xd5, 0x94, 0x6c, 0x91, 0xa9, 0xa3, 0xc8, 0x2a, 0x1d, 0x06, 0x37, 0x35,
+  0x8e, 0x72, 0x0e, 0x12, 0x04, 0x6a, 0x84, 0xc6, 0x2b, 0x5e, 0x4b, 0x51, 0x88, 0x5c, 0x5e, 0x38,
+  0xc0, 0x0d, 0x70, 0xc2, 0x56, 0x14, 0x9a, 0x8a, 0x66, 0x39, 0x2c, 0x81, 0x28, 0x51, 0x13, 0x00,
+  0xc9, 0x2a, 0x95, 0x06, 0x99, 0xc8, 0x54, 0xf4, 0x6e, 0x9c, 0x2b, 0x29, 0xa0, 0xa9, 0x9a, 0xa2,
+  0x84, 0x78, 0x56, 0x04, 0x12, 0x4c, 0xa8, 0x38, 0x2f, 0xff, 0x3d, 0x29, 0x5b, 0xf1, 0x90, 0x50,
+  0x54, 0x25, 0xd8, 0x23, 0x51, 0xf4, 0xb6, 0x40, 0xb6, 0xaf, 0x20, 0x36, 0x32, 0x23, 0x0b, 0x09,
+  0x54, 0xce, 0x5c, 0xd7, 0xb5, 0x2a, 0xf0, 0xca, 0xb5, 0xf0, 0xc9, 0x08, 0xe4, 0xbe, 0xa9, 0x18,
+  0xda, 0x97, 0xb2, 0xee, 0x70, 0xaa, 0x80, 0x42, 0x96, 0x51, 0x21, 0x72, 0x59, 0x02, 0x38, 0x61,
+  0xa2, 0x32, 0x65, 0x14, 0x95, 0x75, 0x57, 0x24, 0x07, 0xa2, 0x50, 0x52, 0x54, 0x88, 0xc0, 0x8a,
+  0xb3, 0xe3, 0xf8, 0x3f, 0x22, 0x04, 0x09, 0xb8, 0x88, 0x08, 0x55, 0xf7, 0x56, 0xbd, 0xa9, 0x69,
+  0x71, 0x7e, 0x59, 0xfc, 0x47, 0x6c, 0x4b, 0xc4, 0xfe, 0x33, 0xf8, 0xaa, 0x2b, 0xe0, 0x5d, 0x2a,
+  0x80, 0x42, 0xe5, 0x22, 0x02, 0xf9, 0xff, 0x4b, 0xd9, 0x91, 0x29, 0x65, 0x3f, 0x35, 0xbf, 0x59,
+  0x1c, 0x8d, 0xa5, 0x89, 0xa2, 0xd2, 0xd7, 0x8f, 0x2d, 0x2d, 0x61, 0x91, 0x8e, 0x27, 0xe4, 0x9c,
+  0x69, 0x00, 0x7d, 0xe6, 0xe7, 0x78, 0xa0, 0x9a, 0xe5, 0xb2, 0x90, 0x89, 0xc5, 0x99, 0xe7, 0x79,
+  0x96, 0xbb, 0x4a, 0x52, 0xb9, 0x89, 0x19, 0xa1, 0x1c, 0x25, 0x16, 0x24, 0x69, 0x1c, 0x82, 0x8d,
+  0xa9, 0x10, 0x2a, 0x99, 0x51, 0x9d, 0x90, 0xb9, 0xc1, 0x81, 0x47, 0x21, 0x19, 0x11, 0x7f, 0xe0,
+  0x40, 0x17, 0xed, 0xec, 0xd8, 0x52, 0x74, 0xfd, 0x83, 0x0e, 0x5d, 0x7b, 0xe7, 0xc3, 0xf4, 0xd9,
+  0x5a, 0xf4, 0x78, 0x0a, 0xce, 0x80, 0xfb, 0x33, 0xe0, 0x72, 0xb2, 0x46, 0xb5, 0xdd, 0xda, 0x63,
+  0xee, 0x2a, 0xfd, 0xe4, 0x77, 0xed, 0x94, 0x21, 0x70, 0x50, 0xf8, 0xed, 0x6b, 0xf1, 0x09, 0x53,
+  0xe9, 0xb1, 0x24, 0x3a, 0x36, 0x1f, 0x63, 0x54, 0x1d, 0xc6, 0x39, 0x8b, 0xf6, 0xd8, 0x0e, 0xaa,
+  0xdb, 0x57, 0xd8, 0x6b, 0xef, 0x7d, 0xbd, 0x57, 0x60, 0x55, 0x7a, 0x3f, 0xae, 0x6a, 0x30, 0x1d,
+  0xe0, 0x94, 0xf5, 0x28, 0xc5, 0xa7, 0x90, 0x20, 0xf2, 0xaa, 0xb9, 0x86, 0xc8, 0x13, 0x6a, 0xef,
+  0x7c, 0x48, 0xb3, 0x63, 0xc0, 0xa3, 0xb1, 0xd4, 0x3b, 0x92, 0x98, 0xb7, 0xc2, 0x0b, 0x19, 0x10,
+  0x7e, 0x09, 0xc1, 0x3e, 0xaf, 0xa6, 0xd3, 0x95, 0x5c, 0xec, 0x64, 0x0a, 0x42, 0x82, 0xe9, 0xfb,
+  0x69, 0x59, 0x0f, 0x4f, 0x8a, 0xad, 0x92, 0xf0, 0xe2, 0x1c, 0x02, 0x0e, 0x4c, 0x12, 0x01, 0x8c,
+  0x1a, 0x31, 0xc5, 0x96, 0x03, 0x52, 0xd4, 0x6d, 0xd7, 0xc8, 0xbc, 0x3f, 0x79, 0xc9, 0xb4, 0x1f,
+  0x43, 0xcc, 0x7a, 0xe2, 0x1b, 0x4f, 0x67, 0xbe, 0x3d, 0xc3, 0x62, 0x35, 0x90, 0xdb, 0x1e, 0x1e,
+  0xf4, 0x1e, 0xc5, 0xaf, 0x6f, 0xc7, 0xf7, 0xc9, 0x50, 0x1a, 0x46, 0xf3, 0xfe, 0xe3, 0xdc, 0x5e,
+  0x34, 0x1a, 0x8d, 0x6b, 0xbb, 0x9f, 0x79, 0xfd, 0x2c, 0x1d, 0x65, 0xd7, 0x4f, 0xbd, 0xed, 0xf8,
+  0x15, 0x0c, 0x70, 0x7b, 0xfc, 0x73, 0x3e, 0x9f, 0xbd, 0x3e, 0x90, 0xe5, 0xf7, 0x97, 0xd9, 0x6c,
+  0x76, 0x9b, 0x43, 0xb2, 0x1c, 0x4e, 0x7d, 0xd6, 0x9d, 0x4c, 0x83, 0xce, 0x13, 0x6e, 0xa3, 0xdb,
+  0x0d, 0xbc, 0xfb, 0x39, 0x78, 0x05, 0x5e, 0x4b, 0xe6, 0x5a, 0xda, 0xa1, 0xfd, 0x3c, 0x7f, 0x6e,
+  0xbf, 0xa2, 0xe6, 0x78, 0x9a, 0x5d, 0xf5, 0xee, 0x7b, 0xbe, 0xdd, 0x07, 0xd1, 0x0f, 0x6a, 0x5c,
+  0x35, 0x56, 0x8f, 0x0b, 0x7b, 0xd8, 0x5f, 0xb3, 0x6d, 0xf0, 0xcb, 0x31, 0x06, 0xcd, 0x65, 0xde,
+  0xce, 0xb7, 0xbf, 0x36, 0x41, 0xdf, 0xbf, 0xed, 0xa1, 0xdf, 0xb1, 0x81, 0x83, 0xd1, 0x66, 0x69,
+  0x6b, 0xdb, 0xfb, 0x47, 0xca, 0x0c, 0xda, 0xc6, 0xba, 0xe1, 0x47, 0xf0, 0x77, 0xcb, 0x48, 0xdd,
+  0xec, 0x6d, 0x1e, 0x4c, 0x16, 0x20, 0x8f, 0x7d, 0x6d, 0x39, 0x58, 0x3c, 0xbb, 0x6f, 0xf9, 0x34,
+  0xc6, 0xcf, 0xf1, 0x64, 0x0c, 0x3a, 0x46, 0x16, 0xbc, 0x7c, 0x9f, 0x8c, 0x8c, 0x16, 0xea, 0x2d,
+  0xd6, 0x24, 0xca, 0x42, 0xe7, 0xc9, 0xc9, 0xb2, 0x79, 0x0f, 0xe1, 0xd1, 0x54, 0xbf, 0x1b, 0x7a,
+  0xcb, 0x5d, 0xcb, 0xfd, 0x87, 0x97, 0x59, 0xc7, 0x4e, 0x82, 0x07, 0x8c, 0xf1, 0xcd, 0xcd, 0xf9,
+  0xa5, 0xb8, 0xf4, 0x6a, 0x82, 0x62, 0x04, 0xb8, 0x22, 0x89, 0x52, 0x5c, 0xb4, 0x93, 0xf6, 0xc7,
+  0x7c, 0xab, 0x77, 0x46, 0xb0, 0xb4, 0x93, 0xc4, 0x9f, 0x7c, 0x13, 0xa3, 0x9b, 0x73, 0xd7, 0x47,
+  0x6e, 0xe0, 0xb0, 0xfc, 0xfc, 0xaf, 0x8a, 0x39, 0x19, 0x5e, 0x11, 0xd7, 0x94, 0x82, 0xaa, 0x73,
+  0xe0, 0x84, 0x48, 0xe1, 0xf0, 0xf0, 0x8a, 0x4a, 0xae, 0x8f, 0xf9, 0x94, 0x21, 0x07, 0x37, 0xf9,
+  0x9e, 0x7e, 0x33, 0x29, 0xf7, 0x55, 0xd7, 0x27, 0x21, 0xbc, 0x68, 0x52, 0x55, 0xbf, 0x3c, 0x26,
+  0xfa, 0x0c, 0x42, 0x58, 0x7a, 0x04, 0x85, 0x30, 0x45, 0xbc, 0x38, 0xbd, 0xb5, 0x5a, 0xbd, 0x93,
+  0x88, 0xdc, 0xef, 0x77, 0x4f, 0x54, 0xb7, 0xca, 0xbf, 0x01, 0xdd, 0x95, 0x52, 0xe4, 0xbf, 0x05,
+  0x00, 0x00,
+};
+
+// wm.js : 273 bytes, 132 gzipped
+const char    WM_ASSET_JS_ETAG[]             = "\"e8196a36294b8407\"";
+const char    WM_ASSET_JS_TAG[]    PROGMEM   = "<script src='/wm.js?v=e8196a36294b8407'></script>";
+const uint8_t WM_ASSET_JS_GZ[]     PROGMEM   =
+{
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x4b, 0x2b, 0xcd, 0x4b, 0x2e, 0xc9,
+  0xcc, 0xcf, 0x53, 0x48, 0xd6, 0xc8, 0xd1, 0xac, 0x4e, 0xc9, 0x4f, 0x2e, 0xcd, 0x4d, 0xcd, 0x2b,
+  0xd1, 0x4b, 0x4f, 0x2d, 0x71, 0xcd, 0x49, 0x05, 0x31, 0x9d, 0x2a, 0x3d, 0x53, 0x34, 0xd4, 0x8b,
+  0xd5, 0x35, 0xf5, 0xca, 0x12, 0x73, 0x4a, 0x53, 0x6d, 0x73, 0xf4, 0x32, 0xf3, 0xf2, 0x52, 0x8b,
+  0x42, 0x52, 0x2b, 0x4a, 0x6a, 0x6a, 0x72, 0xf4, 0x4a, 0x80, 0xb4, 0x73, 0x7e, 0x5e, 0x09, 0x50,
+  0xa5, 0x35, 0x4e, 0xdd, 0x05, 0x40, 0xdd, 0x69, 0x40, 0xc9, 0x62, 0x0d, 0x4d, 0xdc, 0x8a, 0x8a,
+  0x0d, 0x29, 0xb3, 0xc3, 0x90, 0x18, 0x4b, 0x4a, 0x32, 0x73, 0x53, 0xab, 0xf2, 0xf3, 0x52, 0xe1,
+  0x56, 0xc1, 0x04, 0xf4, 0xf2, 0x12, 0x73, 0x53, 0x81, 0x3a, 0x6b, 0x01, 0x21, 0x9e, 0xdd, 0x50,
+  0x11, 0x01, 0x00, 0x00,
+};
+
+// tz.js : 5388 bytes, 1785 gzipped
+const char    WM_ASSET_TZ_ETAG[]             = "\"3eb59e639b32cda2\"";
+const char    WM_ASSET_TZ_TAG[]    PROGMEM   = "<script src='/tz.js?v=3eb59e639b32cda2'></script>";
+const uint8_t WM_ASSET_TZ_GZ[]     PROGMEM   =
+{
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x8d, 0x58, 0x6d, 0x6f, 0xe2, 0x38,
+  0x10, 0xfe, 0x7e, 0xbf, 0x82, 0xfd, 0xd2, 0x04, 0x35, 0x50, 0x08, 0x05, 0x5a, 0x58, 0xae, 0xea,
+  0xdb, 0xb6, 0xbb, 0xdb, 0xee, 0x56, 0xd7, 0xde, 0x9e, 0x7a, 0x08, 0x21, 0x97, 0x18, 0xe2, 0x25,
+  0xd8, 0x3d, 0xdb, 0xe9, 0xab, 0xf8, 0xef, 0x37, 0x4e, 0xe2, 0xc4, 0x49, 0xbc, 0xd2, 0xaa, 0x52,
+  0x05, 0xf3, 0xe6, 0x99, 0xf1, 0xf8, 0x79, 0xa6, 0x75, 0x97, 0x31, 0x5d, 0x48, 0xc2, 0xa8, 0x8b,
+  0x9b, 0xef, 0x4f, 0x88, 0x37, 0xe4, 0x24, 0x97, 0x34, 0xdf, 0x9d, 0x58, 0xe0, 0x86, 0x90, 0x9c,
+  0x2c, 0xa4, 0x33, 0x56, 0x5a, 0x3c, 0x71, 0x84, 0xe3, 0xd1, 0x49, 0xdd, 0xab, 0x85, 0xdb, 0x2b,
+  0x2c, 0xef, 0xc8, 0x06, 0xbf, 0x31, 0x8a, 0xbf, 0x2f, 0x97, 0x02, 0x4b, 0xb7, 0x39, 0xe6, 0x58,
+  0xc6, 0x9c, 0x36, 0xe4, 0x87, 0xc9, 0x84, 0xc6, 0x51, 0x74, 0x24, 0x47, 0x9d, 0xad, 0xc7, 0x0d,
+  0x7f, 0x4f, 0x7a, 0x34, 0x8d, 0xc1, 0x27, 0x14, 0x3f, 0x37, 0xce, 0x90, 0xc4, 0xda, 0x0b, 0x83,
+  0x57, 0x4c, 0x03, 0xbc, 0x24, 0x14, 0x07, 0x3b, 0x3b, 0xbc, 0x0d, 0x31, 0x3f, 0x41, 0x94, 0x7b,
+  0x8c, 0x38, 0x9c, 0xec, 0x25, 0x02, 0xe5, 0xe0, 0xd2, 0xec, 0xcb, 0x35, 0xa3, 0x32, 0x74, 0x25,
+  0x7c, 0xdb, 0x7a, 0xa4, 0x94, 0x65, 0x16, 0x92, 0xba, 0xe0, 0xe9, 0x75, 0x3c, 0xbf, 0xd9, 0xdc,
+  0x7a, 0xe2, 0xd7, 0x16, 0xfd, 0xd4, 0x82, 0x59, 0x2a, 0x4d, 0x0a, 0x4d, 0x0f, 0x6a, 0xfe, 0x39,
+  0x3c, 0x12, 0x6e, 0x22, 0xc8, 0xf3, 0x6a, 0x36, 0x47, 0xa4, 0x26, 0x82, 0x92, 0x55, 0x84, 0xbc,
+  0x1d, 0x2d, 0x0e, 0xa5, 0x41, 0x27, 0x62, 0xb3, 0xdb, 0x69, 0x78, 0xe2, 0x36, 0xa1, 0xc1, 0xc2,
+  0x55, 0x3e, 0xf0, 0xb9, 0x25, 0x8a, 0x2e, 0xf2, 0x8f, 0x9d, 0x23, 0xb9, 0xeb, 0x78, 0x5d, 0x67,
+  0xc4, 0xff, 0xec, 0x1c, 0x51, 0xf5, 0xd1, 0x73, 0x76, 0xf1, 0x48, 0x09, 0x3b, 0xce, 0xd6, 0x43,
+  0xd5, 0x70, 0x78, 0x12, 0x17, 0xee, 0xaa, 0xbd, 0xb2, 0xad, 0xae, 0xe8, 0x5f, 0xb8, 0x22, 0x57,
+  0xb6, 0x59, 0x24, 0x18, 0x6d, 0xcb, 0xec, 0xce, 0xc4, 0x14, 0xcf, 0xa0, 0xe4, 0xa5, 0xa5, 0x64,
+  0x7d, 0x31, 0xae, 0xdf, 0xe9, 0x76, 0xbc, 0x81, 0xd7, 0xed, 0xc3, 0xc1, 0x1d, 0xf5, 0xa3, 0x72,
+  0x7d, 0x77, 0x8e, 0x37, 0x18, 0x66, 0x04, 0xed, 0x9d, 0x61, 0xfa, 0x84, 0xb9, 0x33, 0x32, 0xed,
+  0xbb, 0x9e, 0xef, 0x75, 0x7b, 0x5e, 0x4f, 0xdb, 0xe7, 0xc6, 0xd7, 0xe8, 0x0d, 0xc9, 0x08, 0xd1,
+  0xaa, 0x79, 0xcf, 0xb3, 0x59, 0x9f, 0x86, 0xf0, 0x7b, 0xc5, 0x7e, 0x37, 0x36, 0x7e, 0x21, 0x0b,
+  0x36, 0x3f, 0x25, 0xf2, 0xf5, 0xf7, 0xc2, 0x1f, 0x0b, 0x28, 0x1a, 0x6a, 0x2e, 0x5b, 0xfb, 0xde,
+  0xa1, 0x37, 0xb4, 0x58, 0xdf, 0x22, 0x2a, 0x49, 0x2d, 0x1b, 0x65, 0x6d, 0x4d, 0x1d, 0x6d, 0x1e,
+  0xd9, 0xfc, 0x82, 0x23, 0x18, 0xe5, 0xba, 0x87, 0xdf, 0x85, 0x61, 0xab, 0xe5, 0x0f, 0xe3, 0x85,
+  0x9f, 0x48, 0x80, 0x6b, 0x05, 0x83, 0x83, 0x35, 0x21, 0x36, 0xbf, 0x41, 0x71, 0x64, 0x31, 0xef,
+  0x0e, 0x2c, 0xf1, 0xaf, 0x98, 0x98, 0x1f, 0xd3, 0x15, 0x8e, 0xb0, 0xb0, 0x76, 0xf4, 0xc0, 0x5a,
+  0x32, 0x9a, 0x7f, 0x16, 0xe8, 0x01, 0x47, 0xf5, 0x96, 0xf6, 0x2d, 0x1e, 0x97, 0xe8, 0x09, 0x51,
+  0x54, 0x2d, 0x18, 0xc2, 0xc3, 0xeb, 0xab, 0x19, 0x7f, 0xc3, 0xcf, 0xf3, 0x7b, 0xc6, 0xd7, 0x56,
+  0xf3, 0x61, 0x61, 0x2e, 0x08, 0xda, 0x3b, 0xc1, 0x84, 0xc7, 0xb2, 0x9e, 0xb7, 0x3f, 0x2c, 0xa6,
+  0xd2, 0x39, 0x8f, 0x39, 0x7b, 0xc4, 0x7b, 0x97, 0x38, 0x12, 0x84, 0xae, 0x89, 0xd5, 0x7a, 0xbf,
+  0x6a, 0xfd, 0x59, 0x48, 0x44, 0x1f, 0xe2, 0xc8, 0x62, 0x7d, 0x60, 0x76, 0x51, 0x65, 0x71, 0x86,
+  0x36, 0x48, 0x2c, 0x62, 0x51, 0x6f, 0x46, 0xd7, 0xac, 0x4f, 0x99, 0x7e, 0xc1, 0x3c, 0x16, 0x28,
+  0xc2, 0x1b, 0x9b, 0xed, 0xa0, 0x6c, 0x7b, 0x01, 0xaf, 0xa2, 0x64, 0xd6, 0x39, 0x4c, 0x8f, 0xef,
+  0x78, 0xbd, 0xdc, 0x70, 0x99, 0xcd, 0x15, 0xe1, 0xac, 0x6a, 0xdb, 0xf3, 0xfc, 0xbe, 0x69, 0x7b,
+  0x83, 0x16, 0x64, 0x49, 0x16, 0x7b, 0xc7, 0xf1, 0x62, 0x0d, 0x8f, 0x2d, 0xa8, 0xa6, 0x70, 0xe0,
+  0xf9, 0x03, 0xa3, 0xc1, 0xda, 0xfc, 0x13, 0xf9, 0x59, 0xe9, 0x59, 0xc7, 0x53, 0x8d, 0x80, 0x64,
+  0x7a, 0x96, 0x9b, 0x8e, 0xc8, 0x12, 0xbd, 0x58, 0x27, 0x69, 0x50, 0xb3, 0xbe, 0x60, 0x4c, 0xe0,
+  0xf9, 0x09, 0x7a, 0xb5, 0xda, 0xfb, 0xe9, 0x1d, 0x9a, 0x6f, 0x81, 0xfc, 0x17, 0xe3, 0x88, 0x51,
+  0xab, 0x79, 0xdf, 0x12, 0x3e, 0x90, 0x21, 0x7a, 0xf8, 0xbd, 0xf1, 0xb8, 0x66, 0x62, 0xc1, 0x9e,
+  0x9d, 0x91, 0xcc, 0xba, 0x7f, 0x8f, 0xd7, 0xe0, 0xc1, 0x09, 0x0c, 0x01, 0x5f, 0x15, 0xe2, 0xef,
+  0x1b, 0xb1, 0x2e, 0xbe, 0x7d, 0xe5, 0x48, 0x50, 0xf6, 0x8a, 0xb8, 0x29, 0xfc, 0xcc, 0xd7, 0xb1,
+  0x34, 0x05, 0xf7, 0xa8, 0x22, 0xf8, 0x11, 0xa1, 0x80, 0x3c, 0x31, 0x21, 0x99, 0x19, 0x0b, 0x6d,
+  0x16, 0x21, 0x92, 0x6b, 0x94, 0x88, 0x74, 0x56, 0x84, 0x6a, 0xc7, 0x18, 0xd8, 0x17, 0xba, 0x8b,
+  0xf6, 0x6e, 0x30, 0x97, 0x61, 0xf9, 0xb2, 0x0f, 0xd4, 0xdb, 0xe8, 0xe6, 0x45, 0x6d, 0x73, 0x9c,
+  0x07, 0x20, 0xd7, 0x5f, 0xde, 0x03, 0x0c, 0xf5, 0x6c, 0x80, 0x40, 0x47, 0xc8, 0x0b, 0xc0, 0x71,
+  0x4e, 0xc4, 0x3c, 0x10, 0x72, 0xc4, 0x3c, 0xf8, 0x3d, 0x87, 0x79, 0xe7, 0x72, 0xbe, 0x64, 0x7c,
+  0xb4, 0xdc, 0x6e, 0x81, 0x29, 0x0a, 0x7a, 0x28, 0xb1, 0x40, 0x6d, 0x0f, 0xb0, 0x81, 0xfe, 0xb4,
+  0x2a, 0xb1, 0x40, 0xfd, 0xcc, 0x02, 0xe8, 0xd3, 0x9a, 0xc8, 0x8e, 0xe3, 0x33, 0x1b, 0xfe, 0x4e,
+  0xeb, 0x32, 0x0b, 0xa8, 0xff, 0x02, 0x8b, 0x67, 0x76, 0xc0, 0x9d, 0xda, 0xa4, 0x36, 0xac, 0x9d,
+  0x55, 0x00, 0x69, 0x5a, 0xfa, 0x5a, 0xc7, 0xa0, 0x3a, 0xce, 0x54, 0xb1, 0xa4, 0x06, 0x18, 0x26,
+  0x2a, 0xcc, 0x6c, 0xaf, 0x79, 0x5a, 0x97, 0x55, 0x5e, 0xf1, 0xec, 0x17, 0xb0, 0x3f, 0xb5, 0x8a,
+  0x7f, 0x81, 0xf8, 0x33, 0x1b, 0x54, 0x4f, 0xab, 0x58, 0x6f, 0x31, 0x9a, 0x59, 0x60, 0x62, 0x6a,
+  0xc1, 0x82, 0xba, 0xd9, 0xcc, 0xf2, 0xa6, 0xa7, 0x75, 0x54, 0xa8, 0x5b, 0xe9, 0x6b, 0x39, 0x8b,
+  0x1f, 0x10, 0x51, 0x3e, 0xe5, 0xc7, 0x9e, 0xab, 0x43, 0xa4, 0x9e, 0xdd, 0xd4, 0xf6, 0xf2, 0xb5,
+  0xcd, 0x17, 0x30, 0xe1, 0xb2, 0xb0, 0x4a, 0x80, 0x40, 0x2b, 0x6f, 0x43, 0x44, 0x57, 0x61, 0x7a,
+  0x44, 0x0d, 0x18, 0xea, 0x6f, 0x57, 0xbb, 0xdd, 0xb1, 0xf5, 0x2b, 0xcb, 0x7d, 0x34, 0x6e, 0xcc,
+  0x4c, 0x87, 0x13, 0x4e, 0xc4, 0x03, 0xa2, 0xb8, 0xc8, 0x0e, 0xe5, 0x56, 0xfa, 0x6e, 0xbf, 0xb1,
+  0x78, 0x83, 0x8b, 0xcc, 0x4c, 0x74, 0x31, 0xac, 0xee, 0x10, 0x47, 0xcf, 0x85, 0x55, 0x01, 0x37,
+  0xb3, 0x9c, 0x46, 0xbe, 0x30, 0xa8, 0x03, 0xd6, 0xbf, 0x14, 0xf2, 0xa6, 0xc6, 0xc0, 0x55, 0x98,
+  0x26, 0x1f, 0x77, 0xb4, 0x0a, 0x03, 0x14, 0x98, 0x9d, 0x4d, 0x00, 0x6b, 0xa6, 0x36, 0x7b, 0x6c,
+  0xee, 0xdd, 0x7a, 0x09, 0xa5, 0x53, 0x3e, 0x03, 0x39, 0x6e, 0x47, 0x98, 0xae, 0x64, 0x08, 0x8b,
+  0x77, 0x07, 0x56, 0x6b, 0x3c, 0xed, 0xcc, 0xc6, 0x80, 0x3d, 0xee, 0x58, 0x7c, 0x24, 0x63, 0xb1,
+  0x3b, 0xe9, 0x36, 0xdf, 0x95, 0x54, 0xcc, 0xc6, 0x64, 0x09, 0xeb, 0xa9, 0x01, 0x57, 0xea, 0x9b,
+  0x09, 0x57, 0x2e, 0x6b, 0x36, 0x61, 0x63, 0x9f, 0xb0, 0x0c, 0xe6, 0xb6, 0xdb, 0xd2, 0x36, 0x9f,
+  0x2f, 0xf3, 0xf2, 0xf5, 0x11, 0xb3, 0x65, 0x43, 0x9d, 0xff, 0x61, 0xe2, 0xe4, 0x7f, 0x4b, 0x38,
+  0x39, 0x56, 0xc2, 0x76, 0xbd, 0xb3, 0xa3, 0x56, 0xee, 0x77, 0x8a, 0x36, 0x78, 0x54, 0x8f, 0xc0,
+  0x55, 0xe8, 0x6c, 0x55, 0x9e, 0xbc, 0xe7, 0x1f, 0x8b, 0xad, 0x19, 0x90, 0xb0, 0x35, 0xf4, 0x01,
+  0x80, 0x9d, 0x91, 0x73, 0x2e, 0x17, 0x7b, 0x17, 0xd7, 0x77, 0xbb, 0x5d, 0x1f, 0x7a, 0xd7, 0x1a,
+  0x0c, 0x52, 0xa9, 0xbe, 0x8b, 0x1b, 0x40, 0xa7, 0xf9, 0x4d, 0x0a, 0x51, 0xad, 0x41, 0xa7, 0xa3,
+  0xf6, 0xf8, 0x02, 0xab, 0x02, 0xb4, 0xd6, 0x72, 0xd3, 0xe9, 0x92, 0x51, 0x16, 0xc5, 0x51, 0xac,
+  0x74, 0xfd, 0x61, 0x59, 0x77, 0x8d, 0x38, 0x3c, 0x02, 0x81, 0x44, 0xa2, 0xdc, 0x2f, 0x2b, 0x2f,
+  0xd0, 0xe6, 0x81, 0x24, 0x28, 0x9c, 0xa8, 0x4a, 0x67, 0xd1, 0x45, 0xc8, 0x38, 0x5a, 0x61, 0xa5,
+  0xdc, 0x3f, 0x28, 0x2b, 0xcb, 0x60, 0x90, 0xa8, 0x4b, 0x45, 0x10, 0xb9, 0x80, 0x69, 0xa0, 0x89,
+  0x2e, 0x2b, 0x5b, 0xbb, 0xde, 0x84, 0x0c, 0x53, 0xf2, 0xa2, 0x55, 0x66, 0xd4, 0x9c, 0x12, 0x5a,
+  0xbd, 0x41, 0xd9, 0xe9, 0x22, 0x86, 0x6b, 0xde, 0xa0, 0x08, 0x69, 0xa5, 0xe9, 0x56, 0x30, 0x42,
+  0xaa, 0xf2, 0x84, 0x91, 0xca, 0x39, 0x12, 0x32, 0x8b, 0xd9, 0x29, 0xc7, 0x3c, 0x61, 0x2b, 0x26,
+  0x91, 0xd6, 0x98, 0x01, 0x73, 0x5c, 0x02, 0x9d, 0x3f, 0x2c, 0x7b, 0x9d, 0xc2, 0x5b, 0x59, 0xa4,
+  0xcd, 0xf4, 0x2b, 0x1d, 0xd3, 0x98, 0x94, 0xa9, 0x4c, 0x2f, 0x05, 0x93, 0x6c, 0x7e, 0xc6, 0x80,
+  0x63, 0xd3, 0x44, 0x13, 0xdf, 0x24, 0x51, 0x0b, 0x35, 0xb5, 0xfc, 0x6e, 0x39, 0xf2, 0xad, 0x9c,
+  0xc3, 0x03, 0xa4, 0xc9, 0xa9, 0xdd, 0xca, 0x55, 0x68, 0x40, 0xcb, 0x54, 0xe6, 0xa9, 0xc7, 0x7c,
+  0x85, 0x21, 0x28, 0x85, 0x5a, 0x63, 0x4c, 0xd5, 0x95, 0x11, 0x8e, 0x8b, 0x20, 0xa5, 0xe3, 0x4b,
+  0x2c, 0xd6, 0xea, 0x56, 0x66, 0xd5, 0xd7, 0xc2, 0x6e, 0x55, 0xa8, 0xef, 0x42, 0x31, 0xb7, 0x54,
+  0x04, 0xf3, 0xc6, 0xb2, 0x33, 0xf4, 0x15, 0x6a, 0xcd, 0x29, 0x7a, 0xc4, 0xf3, 0x1f, 0x98, 0x07,
+  0x6a, 0xa2, 0x8a, 0xf0, 0x7f, 0xdf, 0x9d, 0x26, 0xdf, 0x93, 0xc8, 0x29, 0x52, 0x5c, 0x31, 0x1a,
+  0x24, 0xa0, 0x3d, 0x28, 0x89, 0x4f, 0x30, 0x8f, 0x48, 0x26, 0x4e, 0x22, 0xa7, 0xb8, 0x73, 0x05,
+  0x4d, 0x13, 0x99, 0x71, 0x5a, 0x52, 0x2a, 0xff, 0x87, 0xd0, 0x00, 0x66, 0x4d, 0xdd, 0xa2, 0xce,
+  0xbc, 0xcc, 0xbc, 0xba, 0x48, 0x1b, 0xc4, 0x81, 0x56, 0x37, 0xd3, 0x44, 0xb3, 0x54, 0x6c, 0xe4,
+  0x94, 0xd1, 0x85, 0xe7, 0xe4, 0x57, 0x96, 0xa0, 0x37, 0x0e, 0x61, 0x79, 0x50, 0xd2, 0x7d, 0x23,
+  0x48, 0x4a, 0x35, 0xa9, 0xb0, 0xc8, 0x06, 0x40, 0x5b, 0xc9, 0x86, 0x86, 0xe1, 0x57, 0x94, 0xd2,
+  0x7e, 0x3e, 0x97, 0x75, 0xee, 0x49, 0x95, 0x86, 0x07, 0x4c, 0x65, 0xa8, 0x82, 0xf7, 0x7a, 0xa6,
+  0x98, 0x45, 0xe0, 0xa4, 0x66, 0xbc, 0xb7, 0xdf, 0x37, 0xad, 0x65, 0xb8, 0x81, 0x25, 0x40, 0x1d,
+  0x9c, 0xbf, 0xb4, 0x82, 0xed, 0x52, 0x61, 0x7e, 0x70, 0x42, 0x67, 0x20, 0x3b, 0x34, 0x0c, 0xff,
+  0x02, 0x52, 0x63, 0xc9, 0x15, 0xed, 0x9b, 0xad, 0x2d, 0x73, 0x5b, 0xfe, 0xf2, 0x4d, 0x92, 0x04,
+  0xb1, 0xd9, 0xd8, 0x9c, 0x1e, 0x53, 0x79, 0x1e, 0x49, 0x33, 0x9e, 0xe7, 0xf4, 0xfd, 0x2c, 0xf3,
+  0x9c, 0xf8, 0xce, 0xe3, 0x45, 0x02, 0x04, 0x4a, 0x93, 0xdd, 0x78, 0x5d, 0x67, 0xf6, 0x58, 0x13,
+  0x63, 0x2a, 0xce, 0xcf, 0x4e, 0x39, 0x16, 0x84, 0xba, 0xf7, 0x79, 0x94, 0x33, 0xc4, 0x9f, 0x93,
+  0x49, 0x53, 0xaa, 0xea, 0x11, 0xc7, 0x01, 0x8e, 0x10, 0x49, 0xa6, 0x58, 0xe3, 0xb0, 0x85, 0x94,
+  0x53, 0x65, 0x9e, 0x82, 0xc9, 0xbc, 0x99, 0xaa, 0x12, 0xf6, 0xf6, 0x35, 0xa0, 0x58, 0xad, 0x38,
+  0x83, 0x5e, 0x5d, 0x79, 0xc5, 0x78, 0x30, 0xbf, 0x64, 0xcf, 0x49, 0x5c, 0xf3, 0x72, 0x0a, 0xae,
+  0x4e, 0x15, 0x26, 0x0a, 0x67, 0xe4, 0x0f, 0x8a, 0xc3, 0xaa, 0x82, 0x2f, 0x61, 0x32, 0x40, 0xa3,
+  0x38, 0xa9, 0x8c, 0x97, 0xc6, 0x82, 0xa8, 0x09, 0xab, 0xb2, 0x26, 0x80, 0x62, 0xd0, 0xaf, 0x78,
+  0x9d, 0x42, 0x0e, 0x21, 0x52, 0x9b, 0xe8, 0xb0, 0x42, 0x05, 0x77, 0x8c, 0xae, 0x60, 0x04, 0x1f,
+  0xe3, 0x4c, 0x57, 0x39, 0xed, 0x91, 0xa8, 0x80, 0x07, 0x15, 0x5a, 0xfa, 0x4a, 0x38, 0x01, 0xee,
+  0x44, 0x92, 0x38, 0x40, 0xa6, 0x29, 0x3d, 0xe3, 0x97, 0x47, 0xc6, 0xa5, 0x28, 0x31, 0xf4, 0x51,
+  0x26, 0x6c, 0xff, 0x14, 0xf2, 0x6d, 0x22, 0x47, 0x38, 0xfb, 0xb0, 0x6d, 0xba, 0x32, 0x24, 0xa2,
+  0x39, 0xfe, 0x23, 0xf9, 0xd7, 0x54, 0xc6, 0xc2, 0x13, 0xa5, 0x6c, 0xe7, 0x7f, 0xeb, 0xc0, 0x5f,
+  0x32, 0x0b, 0x46, 0x05, 0x8b, 0x60, 0xe3, 0x60, 0x2b, 0xd7, 0xb9, 0x67, 0x31, 0x6f, 0xe8, 0xff,
+  0x4d, 0x36, 0x88, 0x18, 0x39, 0x8d, 0xdd, 0xdc, 0xb7, 0xad, 0x98, 0xdf, 0x6d, 0x36, 0xc7, 0xff,
+  0x03, 0xa2, 0x9c, 0x84, 0xfd, 0x0c, 0x15, 0x00, 0x00,
+};
+
+#endif    // WM_ASSETS_H
@@ -0,0 +1,69 @@
+#!/usr/bin/env python3
+#
+# Regenerates src/utils/WM_Assets.h from the files in utils/assets.
+# Run from the library root after editing an asset:
+#
+#   python3 utils/gen_assets.py
+#
+# Each asset is stored gzipped in PROGMEM, with a strong ETag derived from the compressed bytes.
+# The gzip header has no file name and a zero mtime, so the output only changes when an asset does.
+
+import gzip
+import hashlib
+import os
+
+ROOT    = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+ASSETS  = os.path.join(ROOT, 'utils', 'assets')
+OUTPUT  = os.path.join(ROOT, 'src', 'utils', 'WM_Assets.h')
+
+# (file, C name, tag linking the asset from a page head)
+# The ETag is also appended to the URL, so browsers can cache the asset until the firmware changes it
+FILES = [
+  ('wm.css', 'WM_ASSET_CSS',  "<link rel='stylesheet' href='/%s?v=%s'>"),
+  ('wm.js',  'WM_ASSET_JS',   "<script src='/%s?v=%s'></script>"),
+  ('tz.js',  'WM_ASSET_TZ',   "<script src='/%s?v=%s'></script>"),
+]
+
+def c_array(data):
+  lines = []
+
+  for i in range(0, len(data), 16):
+    lines.append('  ' + ', '.join('0x%02x' % b for b in data[i:i + 16]) + ',')
+
+  return '\n'.join(lines)
+
+def main():
+  out = []
+
+  out.append('// autogenerated from utils/assets by utils/gen_assets.py, do not edit')
+  out.append('')
+  out.append('#ifndef WM_ASSETS_H')
+  out.append('#define WM_ASSETS_H')
+
+  for name, symbol, tag in FILES:
+    with open(os.path.join(ASSETS, name), 'rb') as f:
+      raw = f.read().rstrip(b'\n')
+
+    data = gzip.compress(raw, compresslevel=9, mtime=0)
+    etag = hashlib.sha1(data).hexdigest()[:16]
+
+    out.append('')
+    out.append('// %s : %d bytes, %d gzipped' % (name, len(raw), len(data)))
+    out.append('const char    %-20s           = "\\"%s\\"";' % (symbol + '_ETAG[]', etag))
+    out.append('const char    %-20s PROGMEM   = "%s";' % (symbol + '_TAG[]', tag % (name, etag)))
+    out.append('const uint8_t %-20s PROGMEM   =' % (symbol + '_GZ[]'))
+    out.append('{')
+    out.append(c_array(data))
+    out.append('};')
+
+  out.append('')
+  out.append('#endif    // WM_ASSETS_H')
+  out.append('')
+
+  with open(OUTPUT, 'w', newline='\n') as f:
+    f.write('\n'.join(out))
+
+  print('Wrote ' + os.path.relpath(OUTPUT, ROOT))
+
+if __name__ == '__main__':
+  main()
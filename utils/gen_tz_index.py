@@ -0,0 +1,161 @@
+#!/usr/bin/env python3
+#
+# Regenerates src/utils/TZ_Index.h from the TZ_NAME / ESP_TZ_NAME tables of src/utils/TZ.h.
+# Run from the library root after updating TZ.h:
+#
+#   python3 utils/gen_tz_index.py
+#
+# For every USING_<REGION> group, the timezone names are sorted and packed into one PROGMEM
+# string pool, the POSIX TZ strings are deduplicated into a second pool, and an index of
+# { name offset, value offset } pairs makes getTZ() a binary search.
+
+import os
+import re
+
+ROOT    = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+INPUT   = os.path.join(ROOT, 'src', 'utils', 'TZ.h')
+OUTPUT  = os.path.join(ROOT, 'src', 'utils', 'TZ_Index.h')
+
+def parse_groups(text, table):
+  # Entries of table, grouped by their USING_<REGION> block, in file order
+  body    = re.search(r'static const char ' + table + r'\[\]\[TIMEZONE_MAX_LEN\][^=]*=\s*\{(.*?)\n\};', text, re.S).group(1)
+  groups  = []
+
+  for m in re.finditer(r'#if (USING_\w+)(.*?)#endif', body, re.S):
+    entries = []
+
+    for line in m.group(2).splitlines():
+      line = line.split('//')[0].strip().rstrip(',')
+
+      if line:
+        entries.append(line)
+
+    groups.append((m.group(1), entries))
+
+  return groups
+
+def unquote(literal):
+  # TZ_NAME entries are plain "..." literals without escapes
+  assert literal.startswith('"') and literal.endswith('"'), literal
+  return literal[1:-1]
+
+def c_string(s):
+  return s.replace('\\', '\\\\').replace('"', '\\"')
+
+def c_pool(strings):
+  # One string per line, each with its explicit NUL
+  return '\n'.join('  "%s\\0"' % c_string(s) for s in strings)
+
+def main():
+  with open(INPUT, 'r') as f:
+    text = f.read()
+
+  values = dict((m.group(1), m.group(2)) for m in re.finditer(r'#define (TZ_\w+)\s+\("(.*)"\)', text))
+
+  names   = parse_groups(text, 'TZ_NAME')
+  posix   = parse_groups(text, 'ESP_TZ_NAME')
+
+  assert [g for g, _ in names] == [g for g, _ in posix]
+
+  out         = []
+  regions     = []
+  maxValueLen = 0
+
+  out.append('// autogenerated from utils/TZ.h by utils/gen_tz_index.py, do not edit')
+  out.append('')
+  out.append('#ifndef TZ_INDEX_H')
+  out.append('#define TZ_INDEX_H')
+  out.append('')
+  out.append('#include "TZ.h"')
+
+  for (group, groupNames), (_, groupMacros) in zip(names, posix):
+    assert len(groupNames) == len(groupMacros), group
+
+    entries = sorted(zip([unquote(n) for n in groupNames], [values[m] for m in groupMacros]),
+                     key=lambda e: e[0].encode())
+
+    # Exact duplicates would make the binary search ambiguous
+    assert len(set(n for n, _ in entries)) == len(entries), group
+
+    pool        = []
+    valueOffset = {}
+    valueLen    = 0
+
+    for _, v in entries:
+      if v not in valueOffset:
+        valueOffset[v] = valueLen
+        pool.append(v)
+        valueLen += len(v) + 1
+        maxValueLen = max(maxValueLen, len(v))
+
+    index   = []
+    nameLen = 0
+
+    for n, v in entries:
+      index.append((nameLen, valueOffset[v]))
+      nameLen += len(n) + 1
+
+    assert nameLen < 0x10000 and valueLen < 0x10000, group
+
+    region = group[len('USING_'):]
+
+    out.append('')
+    out.append('#if %s' % group)
+    out.append('')
+    out.append('// %d timezones, %d bytes of names, %d bytes of distinct TZ strings' % (len(entries), nameLen, valueLen))
+    out.append('const char     %-28s PROGMEM =' % ('WM_TZ_%s_NAMES[]' % region))
+    out.append(c_pool([n for n, _ in entries]) + ';')
+    out.append('')
+    out.append('const char     %-28s PROGMEM =' % ('WM_TZ_%s_VALUES[]' % region))
+    out.append(c_pool(pool) + ';')
+    out.append('')
+    out.append('// { name offset, value offset }, sorted by name')
+    out.append('const uint16_t %-28s PROGMEM =' % ('WM_TZ_%s_INDEX[][2]' % region))
+    out.append('{')
+
+    for i in range(0, len(index), 6):
+      out.append('  ' + ' '.join('{ %4d, %4d },' % e for e in index[i:i + 6]))
+
+    out.append('};')
+    out.append('')
+    out.append('#endif    // %s' % group)
+
+    regions.append((group, region))
+
+  out.append('')
+  out.append('////////////////////////////////////////////////////////////')
+  out.append('')
+  out.append('// Longest POSIX TZ string, over all regions')
+  out.append('#define WM_TZ_VALUE_MAX_LEN       %d' % maxValueLen)
+  out.append('')
+  out.append('typedef struct')
+  out.append('{')
+  out.append('  PGM_P             names;')
+  out.append('  PGM_P             values;')
+  out.append('  const uint16_t    (*index)[2];')
+  out.append('  uint16_t          count;')
+  out.append('} WM_TZ_Region;')
+  out.append('')
+  out.append('// Enabled USING_<REGION> groups. The names are sorted within a region, not across regions')
+  out.append('static const WM_TZ_Region WM_TZ_REGIONS[] =')
+  out.append('{')
+
+  for group, region in regions:
+    out.append('#if %s' % group)
+    out.append('  { WM_TZ_%s_NAMES, WM_TZ_%s_VALUES, WM_TZ_%s_INDEX, sizeof(WM_TZ_%s_INDEX) / sizeof(WM_TZ_%s_INDEX[0]) },'
+               % (region, region, region, region, region))
+    out.append('#endif')
+
+  out.append('  { NULL, NULL, NULL, 0 }    // End of the enabled regions')
+  out.append('};')
+  out.append('')
+  out.append('#endif    // TZ_INDEX_H')
+  out.append('')
+
+  with open(OUTPUT, 'w', newline='\n') as f:
+    f.write('\n'.join(out))
+
+  print('Wrote ' + os.path.relpath(OUTPUT, ROOT))
+
+if __name__ == '__main__':
+  main()